@@ -23,6 +23,7 @@ arc_define_feature(IOCP ON OFF "Enable IOCP driver (windows only)")
 arc_define_feature(DEBUG OFF OFF "Enable debug assertions")
 arc_define_feature(TRACE OFF OFF "Enable debug tracing")
 arc_define_feature(ASAN OFF OFF "Enable AddressSanitizer")
+arc_define_feature(STATIC_DISPATCH OFF OFF "Call runtime internals directly instead of through ABI vtables")
 
 if (ARC_ENABLED_FEATURES)
     list(JOIN ARC_ENABLED_FEATURES ", " ARC_ENABLED_FEATURES)
@@ -63,3 +64,6 @@ endif()
 if(ARC_FEATURE_TRACE)
     list(APPEND ARC_FEATURE_DEFINES ARC_ENABLE_TRACE=1)
 endif()
+if(ARC_FEATURE_STATIC_DISPATCH)
+    list(APPEND ARC_FEATURE_DEFINES ARC_STATIC_DISPATCH=1)
+endif()
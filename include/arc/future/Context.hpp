@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <exception>
 #include <source_location>
 #include <asp/time/Instant.hpp>
@@ -12,6 +13,8 @@ struct Waker;
 class Runtime;
 struct TaskBase;
 struct PollableBase;
+struct PromiseBase;
+struct ChainRoot;
 
 class Context {
 public:
@@ -26,8 +29,62 @@ public:
 
     void _installWaker(Waker* waker) noexcept;
 
+    /// Called by a future polled as a root, returns the previously running chain which is restored by `_exitChain`.
+    /// This is all the bookkeeping done per poll, so it's kept inline.
+    ChainRoot* _enterChain(ChainRoot* root) noexcept {
+        auto prev = m_chain;
+        m_chain = root;
+        return prev;
+    }
+
+    void _exitChain(ChainRoot* prev) noexcept {
+        m_chain = prev;
+    }
+
+    /// Budget value that never runs out, used for contexts that are not driven by a runtime worker.
+    static constexpr uint32_t UNCONSTRAINED_BUDGET = UINT32_MAX;
+
+    /// Consumes one unit of the cooperative budget of the current poll.
+    /// Returns false if the budget is already spent and the caller should yield, the caller is responsible for waking.
+    bool consumeBudget() noexcept {
+        if (m_budget == UNCONSTRAINED_BUDGET) return true;
+        if (m_budget == 0) return false;
+        m_budget--;
+        return true;
+    }
+
+    /// Same as `!consumeBudget()`, kept out of line for code built against older versions.
     bool shouldCoopYield() noexcept;
 
+    /// Should be called by resource operations (channel receives, lock acquisitions, socket reads and so on)
+    /// before doing any work. Returns false if the budget is spent, in which case the task has already been woken,
+    /// and the operation must return pending without side effects, so the task yields back to the runtime.
+    bool pollBudget() noexcept {
+        if (!this->consumeBudget()) [[unlikely]] {
+            this->wake();
+            return false;
+        }
+        return true;
+    }
+
+    /// Returns true if the budget is spent, without consuming anything.
+    /// Awaiting a future only checks this, so plain computation split into many futures is not charged.
+    bool budgetSpent() const noexcept {
+        return m_budget == 0;
+    }
+
+    /// Returns the number of operations left before the task is forced to yield.
+    uint32_t remainingBudget() const noexcept {
+        return m_budget;
+    }
+
+    /// Overrides the budget of the current poll, called by tasks that have a custom budget.
+    void _setBudget(uint32_t budget) noexcept {
+        m_budget = budget;
+    }
+
+    /// Futures are tracked automatically at no cost, and the stack is reconstructed when an exception is captured.
+    /// These can be used to explicitly add other pollables to the stack trace.
     void pushFrame(const PollableBase* pollable);
     void popFrame() noexcept;
     void markFrame(asp::UniqueBoxedString name) noexcept;
@@ -41,7 +98,7 @@ private:
     friend class Runtime;
 
     /// Setup the context for a new task execution.
-    void setup(asp::Instant taskDeadline) noexcept;
+    void setup(uint32_t budget) noexcept;
 
     struct StackEntry {
         const PollableBase* pollable;
@@ -50,12 +107,17 @@ private:
 
     Waker* m_waker;
     Runtime* m_runtime;
-    uint32_t m_futurePolls = 0;
-    uint64_t m_taskDeadline = 0;
+    uint32_t m_futurePolls = 0; // unused, kept for layout
+    uint64_t m_taskDeadline = 0; // unused, kept for layout
     std::exception_ptr m_unused;
     std::vector<StackEntry> m_stack;
     std::vector<asp::UniqueBoxedString> m_capturedStack;
     // -- all fields above are expected to be stable and not change --
+    ChainRoot* m_chain = nullptr; // the chain of coroutines that is currently running
+    uint32_t m_budget = UNCONSTRAINED_BUDGET; // resource operations left before the task must yield
+    // chain that was running when each entry of m_stack was pushed. Kept separate so StackEntry stays stable,
+    // it can be shorter than m_stack if another copy of Arc pushed frames, those are treated as outside any chain
+    std::vector<const ChainRoot*> m_stackChains;
 
     void captureStack();
 };
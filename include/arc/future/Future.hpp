@@ -77,7 +77,7 @@ struct ARC_NODISCARD Future : PollableBase {
     }
 
     bool coopYield(Context& cx) {
-        if (!cx.shouldCoopYield()) return false;
+        if (!cx.budgetSpent()) return false;
 
         ARC_TRACE("[{}] cooperatively yielding", this->debugName());
         cx.wake();
@@ -89,7 +89,7 @@ struct ARC_NODISCARD Future : PollableBase {
         return m_handle ? m_handle.done() : true;
     }
 
-    bool await_suspend(std::coroutine_handle<> awaiting) {
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
         // ARC_TRACE("[{}] await_suspend({}), child: {}", this->debugName(), awaiting.address(), (void*)this->child());
 
         this->attachToParent(awaiting);
@@ -97,28 +97,30 @@ struct ARC_NODISCARD Future : PollableBase {
         auto cx = this->contextFromParent();
         ARC_ASSERT(cx, "context is null in await_suspend");
 
-        if (this->coopYield(*cx)) {
-            return true;
-        }
-
-        this->promise().setContext(cx);
+        auto& promise = this->promise();
+        auto& parent = std::coroutine_handle<Promise<void>>::from_address(awaiting.address()).promise();
 
-        bool doSuspend = true;
+        if (promise.isLinked()) {
+            // this future was already polled on its own, so it stays the root of its own chain
+            // and the awaiting coroutine polls it like any other pollable
+            if (this->poll(*cx)) {
+                parent.attachChild(nullptr);
+                return awaiting;
+            }
 
-        // if we don't have a child, wake the current task immediately
-        if (!this->child()) {
-            // ARC_TRACE("[{}] await_suspend(): no child, resuming immediately", this->debugName());
+            return std::noop_coroutine();
+        }
 
-            cx->pushFrame(this);
-            m_handle.resume();
-            cx->popFrame();
+        ARC_DEBUG_ASSERT(parent.isLinked(), "awaiting coroutine is not part of a chain");
+        promise.linkTo(parent);
 
-            if (m_handle.done()) {
-                doSuspend = false;
-            }
+        if (this->coopYield(*cx)) {
+            // the next poll of the root starts this future, since it's the leaf now
+            return std::noop_coroutine();
         }
 
-        return doSuspend;
+        // symmetric transfer, the awaiting coroutine is resumed by our final awaiter
+        return m_handle;
     }
 
     T await_resume() {
@@ -126,52 +128,33 @@ struct ARC_NODISCARD Future : PollableBase {
         return this->getOutput();
     }
 
+    /// Polls the future as the root of a chain. Only the innermost running coroutine is touched,
+    /// so the cost of a poll does not depend on how many futures are awaiting each other.
     bool poll(Context& cx) noexcept {
         ARC_DEBUG_ASSERT(m_handle, "polling a future with an invalid handle");
 
-        auto child = this->child();
-        auto resume = [&] noexcept {
-            auto& promise = this->promise();
-            promise.setContext(&cx);
-
-            cx.pushFrame(this);
-
-            try {
-                m_handle.resume();
-            } catch (const std::exception& e) {
-                printError("[{}] future threw when calling handle.resume(): {}", this->debugName(), e.what());
-                cx.dumpStack();
-                std::terminate();
-            }
+        if (m_handle.done()) {
+            return true;
+        }
 
-            cx.popFrame();
+        auto& root = this->promise();
+        if (!root.isLinked()) {
+            root.makeRoot();
+        }
 
-            if (m_handle.done()) {
-                return true;
-            }
-            return false;
-        };
+        ARC_DEBUG_ASSERT(!root.m_parent, "polling a future that is being awaited by another future");
 
-        // ARC_TRACE("[{}] poll(), child: {}", this->debugName(), (void*)child);
+        // no frames are pushed, a stack trace can be reconstructed from these links if needed
+        auto chain = root.m_root;
+        root.setContext(&cx);
+        chain->future = this;
+        chain->outer = cx._enterChain(chain);
 
-        if (child) {
-            cx.pushFrame(this);
+        bool done = this->pollLeaf(*chain, cx);
 
-            bool done = child->m_vtable->poll(child, cx);
-            cx.popFrame();
+        cx._exitChain(chain->outer);
 
-            // ARC_TRACE("[{}] poll() -> child done: {}", this->debugName(), done);
-            if (done) {
-                this->promise().attachChild(nullptr);
-                return resume();
-            }
-            return false;
-        } else {
-            if (m_handle.done()) {
-                return true;
-            }
-            return resume();
-        }
+        return done;
     }
 
     T getOutput() {
@@ -184,6 +167,32 @@ struct ARC_NODISCARD Future : PollableBase {
 protected:
     handle_type m_handle{};
 
+    bool pollLeaf(ChainRoot& chain, Context& cx) noexcept {
+        auto leaf = chain.leaf;
+        leaf->setContext(&cx);
+
+        // ARC_TRACE("[{}] poll(), leaf: {}, child: {}", this->debugName(), (void*)leaf, (void*)leaf->getChild());
+
+        // the leaf is suspended on a pollable, nothing can progress until that is ready
+        if (auto child = leaf->getChild()) {
+            if (!child->m_vtable->poll(child, cx)) {
+                return false;
+            }
+
+            leaf->attachChild(nullptr);
+        }
+
+        try {
+            leaf->m_self.resume();
+        } catch (const std::exception& e) {
+            printError("[{}] future threw when calling handle.resume(): {}", this->debugName(), e.what());
+            cx.dumpStack();
+            std::terminate();
+        }
+
+        return m_handle.done();
+    }
+
     static bool vPoll(void* self, Context& cx) noexcept {
         auto me = static_cast<Future*>(self);
         return me->poll(cx);
@@ -218,7 +227,9 @@ protected:
 
 template <typename T>
 auto Promise<T>::get_return_object() noexcept {
-    return Future<T>{ Future<T>::handle_type::from_promise(*this) };
+    auto handle = Future<T>::handle_type::from_promise(*this);
+    this->m_self = handle;
+    return Future<T>{ handle };
 }
 
 template <typename Fut, typename Out = typename FutureTraits<std::decay_t<Fut>>::Output>
@@ -2,6 +2,7 @@
 #include "Pollable.hpp"
 #include <arc/util/Trace.hpp>
 #include <arc/util/MaybeUninit.hpp>
+#include <arc/util/Pool.hpp>
 
 namespace arc {
 
@@ -37,7 +38,29 @@ struct PromiseVtable {
     }
 };
 
-struct PromiseBase {
+struct PromiseBase;
+
+/// State of a whole chain of coroutines (see `PromiseBase`), owned by the root promise.
+/// It is kept out of the coroutine frames, so nested futures only pay for the links to their parent and root.
+struct ChainRoot : pool::Pooled {
+    PromiseBase* leaf = nullptr; // the innermost coroutine, which is the one resumed on the next poll
+    ChainRoot* outer = nullptr; // the chain that was running when this one was last polled
+    const PollableBase* future = nullptr; // the future that was last polled as the root
+};
+
+/// Coroutine frames are allocated through the promise type, so every future frame comes from the thread-local pools.
+/// Frames of the same coroutine always have the same size, which makes them recycle very well.
+struct PromiseBase : pool::Pooled {
+    PromiseBase() noexcept = default;
+    PromiseBase(const PromiseBase&) = delete;
+    PromiseBase& operator=(const PromiseBase&) = delete;
+
+    ~PromiseBase() {
+        if (m_root && !m_parent) {
+            delete m_root;
+        }
+    }
+
     void attachChild(PollableBase* child) noexcept {
         m_child = child;
     }
@@ -55,11 +78,19 @@ struct PromiseBase {
     }
 
     void setDebugName(asp::BoxedString name) {
+#ifdef ARC_STATIC_DISPATCH
+        vSetDebugName(this, std::move(name));
+#else
         m_vtable->setDebugName(this, std::move(name));
+#endif
     }
 
     asp::BoxedString getDebugName() {
+#ifdef ARC_STATIC_DISPATCH
+        return vGetDebugName(this);
+#else
         return m_vtable->getDebugName(this);
+#endif
     }
 
     template <typename T>
@@ -103,11 +134,59 @@ protected:
     Context* m_context = nullptr;
     std::exception_ptr m_exception;
 
+    // Every future that is polled directly is the root of a chain, and every future awaited inside it (recursively)
+    // is linked into the same chain. The chain state points at the innermost running coroutine (the leaf),
+    // so a wake resumes the leaf directly instead of walking down through every frame,
+    // and a completing coroutine transfers control straight to the one awaiting it.
+    // Either way, the cost does not depend on how deeply the futures are nested.
+    // These links are read and written by inline code in Future and Context, so they are part of the stable layout:
+    // adding them was an ABI break, frames built by a copy of Arc from before the chains cannot be awaited by this one.
+    std::coroutine_handle<> m_self;
+    PromiseBase* m_parent = nullptr; // the promise awaiting this one, null for roots
+    ChainRoot* m_root = nullptr; // owned by the root promise
+    asp::UniqueBoxedString m_frameName;
+
     // Every field past this comment can be changed without causing an ABI break.
     // Fields must never be directly accessed and should only be used through the vtable.
     // Fields above must stay stable, they are accessed by offset for performance reasons.
     asp::BoxedString m_debugName;
 
+    template <typename T>
+    friend struct Future;
+    friend class Context;
+
+    bool isLinked() const noexcept {
+        return m_root != nullptr;
+    }
+
+    /// Makes this the root of a new chain, with itself as the leaf
+    void makeRoot() {
+        m_root = new ChainRoot{};
+        m_root->leaf = this;
+    }
+
+    /// Links this (not yet started) coroutine into the chain of `parent`, and makes it the leaf.
+    /// Only the running coroutine's context is kept up to date, which is enough since nothing else can observe it.
+    void linkTo(PromiseBase& parent) noexcept {
+        m_parent = &parent;
+        m_root = parent.m_root;
+        m_root->leaf = this;
+        m_context = parent.m_context;
+    }
+
+    /// Called on final suspend, returns the coroutine that control should be transferred to
+    std::coroutine_handle<> unlink() noexcept {
+        if (!m_parent) {
+            return std::noop_coroutine();
+        }
+
+        // the parent might have last run on a different worker
+        m_parent->m_child = nullptr;
+        m_parent->m_context = m_context;
+        m_root->leaf = m_parent;
+        return m_parent->m_self;
+    }
+
     static void vSetDebugName(void* self, asp::BoxedString name) {
         reinterpret_cast<PromiseBase*>(self)->m_debugName = std::move(name);
     }
@@ -145,7 +224,11 @@ struct PromiseBaseNV : PromiseBase {
     void return_value(From&& from) {
         // ARC_TRACE("[Promise {}] return_value()", (void*)this);
         R value = static_cast<R>(std::forward<From>(from));
+#ifdef ARC_STATIC_DISPATCH
+        vDeliverOutput(this, &value);
+#else
         this->deliverOutput(&value);
+#endif
     }
 
 protected:
@@ -201,7 +284,10 @@ struct Promise : std::conditional_t<
     struct FinalAwaiter {
         bool await_ready() noexcept { return false; }
         void await_resume() noexcept {}
-        void await_suspend(std::coroutine_handle<promise_type> h) noexcept {}
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+            // symmetric transfer back to the awaiting coroutine, if any
+            return h.promise().unlink();
+        }
     };
 
     auto final_suspend() noexcept {
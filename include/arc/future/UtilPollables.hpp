@@ -45,7 +45,7 @@ struct ARC_NODISCARD CoopYield : NoexceptPollable<CoopYield> {
     bool poll(Context& cx) noexcept {
         if (yielded) return true;
 
-        if (!cx.shouldCoopYield()) {
+        if (cx.consumeBudget()) {
             return true;
         }
 
@@ -59,7 +59,8 @@ private:
     bool yielded = false;
 };
 
-/// Yields if the current task has been running for way too long without yielding.
+/// Consumes a unit of the task's cooperative budget, and yields if it is used up.
+/// Useful in loops that only await things that are always ready.
 inline CoopYield coopYield() noexcept {
     return CoopYield{};
 }
@@ -130,6 +130,10 @@ protected:
     /// Otherwise it loops, then calls pollReady and your function again.
     template <typename T = std::monostate>
     std::optional<NetResult<T>> pollCustom(Context& cx, uint64_t& id, Interest interest, auto fn) {
+        if (!cx.pollBudget()) {
+            return std::nullopt;
+        }
+
         while (true) {
             auto ready = m_io.pollReady(interest, cx, id);
             if (ready == 0) {
@@ -7,13 +7,24 @@
 #include "runtime/Main.hpp"
 
 #include "sync/mpsc.hpp"
+#include "sync/mpmc.hpp"
+#include "sync/weighted.hpp"
 #include "sync/oneshot.hpp"
 #include "sync/Notify.hpp"
 #include "sync/Mutex.hpp"
+#include "sync/RwLock.hpp"
+#include "sync/Condvar.hpp"
 #include "sync/Semaphore.hpp"
+#include "sync/ShardedSemaphore.hpp"
+#include "sync/Barrier.hpp"
+#include "sync/Latch.hpp"
+#include "sync/OnceCell.hpp"
+#include "sync/AsyncCache.hpp"
 
 #include "task/Task.hpp"
 #include "task/BlockingTask.hpp"
+#include "task/AtomicWaker.hpp"
+#include "task/Parker.hpp"
 #include "task/CancellationToken.hpp"
 #include "task/CondvarWaker.hpp"
 #include "task/Yield.hpp"
@@ -25,6 +36,7 @@
 #include "util/Function.hpp"
 #include "util/ManuallyDrop.hpp"
 #include "util/MaybeUninit.hpp"
+#include "util/Pool.hpp"
 #include "util/ScopeDtor.hpp"
 #include "util/Trace.hpp"
 
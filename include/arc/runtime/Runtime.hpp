@@ -2,15 +2,18 @@
 #include <thread>
 #include <vector>
 #include <deque>
-#include <unordered_set>
 #include <cstddef>
+#include <memory>
 #include <condition_variable>
 #include <arc/task/Task.hpp>
 #include <arc/task/BlockingTask.hpp>
 #include <arc/task/CondvarWaker.hpp>
+#include <arc/task/Parker.hpp>
+#include <arc/task/TaskRegistry.hpp>
 
 #include <asp/time/Duration.hpp>
 #include <asp/ptr/SharedPtr.hpp>
+#include <asp/collections/SmallVec.hpp>
 #include <asp/time/sleep.hpp>
 #include <arc/util/Function.hpp>
 
@@ -49,6 +52,7 @@ struct RuntimeVtable {
     using SafeShutdownFn = void(*)(Runtime*);
     using GetDriverFn = void*(*)(Runtime*, DriverType) noexcept;
     using GetTaskStats = void(*)(Runtime*, std::vector<asp::SharedPtr<TaskDebugData>>&);
+    using EnqueueTasksFn = void(*)(Runtime*, TaskBase* const*, size_t, bool);
 
     EnqueueTaskFn m_enqueueTask = nullptr;
     SetTerminateHandlerFn m_setTerminateHandler = nullptr;
@@ -59,6 +63,7 @@ struct RuntimeVtable {
     SafeShutdownFn m_safeShutdown = nullptr;
     GetDriverFn m_getDriver = nullptr;
     GetTaskStats m_getTaskStats = nullptr;
+    EnqueueTasksFn m_enqueueTasks = nullptr;
 };
 
 template <typename T>
@@ -85,6 +90,10 @@ struct RuntimeOptions {
     bool ioDriver = true;
     bool signalDriver = true;
     bool iocpDriver = true;
+    /// Number of resource operations (channel receives, lock acquisitions, socket reads, awaits and so on)
+    /// a task may complete in one poll before it is forced to yield back to the runtime. 0 disables the budget.
+    /// Individual tasks can override this with `TaskHandle::setCoopBudget`.
+    uint32_t coopBudget = 128;
 };
 
 class Runtime : public asp::EnableSharedFromThis<Runtime> {
@@ -126,11 +135,17 @@ public:
     void setTerminateHandler(TerminateHandler handler);
 
     void enqueueTask(TaskBase* task);
+    /// Enqueues several tasks at once, taking the run queue lock once and waking at most one idle worker per task.
+    void enqueueTasks(TaskBase* const* tasks, size_t count);
 
     template <typename F> requires Spawnable<std::decay_t<F>>
     auto spawn(F&& func) {
         auto task = createTask(std::forward<F>(func));
+#ifdef ARC_STATIC_DISPATCH
+        Runtime::vInsertTask(this, task);
+#else
         m_vtable->m_insertTask(this, task);
+#endif
         task->schedule();
 
         return TaskHandle{task};
@@ -139,7 +154,11 @@ public:
     template <typename T = void>
     BlockingTaskHandle<T> spawnBlocking(arc::MoveOnlyFunction<T()> func) {
         BlockingTaskHandle<T> handle{ BlockingTask<T>::create(weakFromThis(), std::move(func)) };
+#ifdef ARC_STATIC_DISPATCH
+        Runtime::vInsertBlocking(this, handle.m_task);
+#else
         m_vtable->m_insertBlocking(this, handle.m_task);
+#endif
         return handle;
     }
 
@@ -161,10 +180,12 @@ public:
 private:
     template <IsPollable Fut, typename Lambda>
     friend struct Task;
+    friend class WakeBatch;
 
     struct WorkerData {
         std::thread thread;
         size_t id;
+        std::unique_ptr<Parker> parker;
     };
 
     const RuntimeVtable* m_vtable;
@@ -187,11 +208,11 @@ private:
 #endif
 
     std::mutex m_mtx;
-    asp::SpinLock<std::unordered_set<TaskBase*>> m_tasks;
+    TaskRegistry m_tasks;
     std::deque<TaskBase*> m_runQueue; // protected by m_mtx
     std::vector<WorkerData> m_workers;
-    std::condition_variable m_cv;
-    asp::time::Duration m_taskDeadline;
+    std::vector<WorkerData*> m_idleWorkers; // protected by m_mtx
+    uint32_t m_coopBudget = Context::UNCONSTRAINED_BUDGET;
 
 
     std::mutex m_blockingMtx;
@@ -208,7 +229,11 @@ private:
 
     template <typename T>
     T& getDriver(DriverType ty) {
+#ifdef ARC_STATIC_DISPATCH
+        auto ptr = static_cast<T*>(Runtime::vGetDriver(this, ty));
+#else
         auto ptr = static_cast<T*>(m_vtable->m_getDriver(this, ty));
+#endif
         ARC_ASSERT(ptr, "attempted to access driver that is not available");
         return *ptr;
     }
@@ -244,6 +269,35 @@ private:
     static void vSafeShutdown(Runtime* self);
     static void* vGetDriver(Runtime* self, DriverType ty) noexcept;
     static void vGetTaskStats(Runtime* self, std::vector<asp::SharedPtr<TaskDebugData>>& out);
+    /// `fromWorker` is set when one of this runtime's workers enqueues the tasks and is about to pick one up itself,
+    /// in which case one less idle worker is woken.
+    void enqueueTasks(TaskBase* const* tasks, size_t count, bool fromWorker);
+    static void vEnqueueTasks(Runtime* self, TaskBase* const* tasks, size_t count, bool fromWorker);
+};
+
+/// While alive, collects the tasks of `runtime` that get scheduled on the current thread,
+/// and enqueues them all at once when destroyed or flushed.
+/// The runtime uses this around driver passes, which can wake thousands of tasks in one go.
+/// Batches can be nested, tasks go to the innermost one. Tasks of other runtimes are enqueued right away.
+class WakeBatch {
+public:
+    explicit WakeBatch(Runtime* runtime) noexcept;
+    ~WakeBatch();
+
+    WakeBatch(const WakeBatch&) = delete;
+    WakeBatch& operator=(const WakeBatch&) = delete;
+
+    /// Enqueues everything collected so far
+    void flush();
+
+    /// Adds the task to the innermost batch of the current thread.
+    /// Returns false if there is none, or it belongs to a different runtime.
+    static bool tryPush(Runtime* runtime, TaskBase* task);
+
+private:
+    Runtime* m_runtime;
+    WakeBatch* m_prev;
+    asp::SmallVec<TaskBase*, 64> m_tasks;
 };
 
 /// Sets the global runtime that will be returned from `Runtime::current()`.
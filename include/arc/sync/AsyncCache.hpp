@@ -0,0 +1,348 @@
+#pragma once
+
+#include <arc/future/Pollable.hpp>
+#include <arc/sync/Notify.hpp>
+#include <arc/util/Assert.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <asp/ptr/SharedPtr.hpp>
+#include <asp/time/Instant.hpp>
+#include <asp/time/Duration.hpp>
+#include <unordered_map>
+#include <functional>
+#include <optional>
+#include <memory>
+#include <deque>
+#include <atomic>
+
+namespace arc {
+
+/// A sharded, size-bounded cache of asynchronously computed values with a fixed time-to-live.
+/// Concurrent lookups of a missing key are coalesced: exactly one task runs the fetch function (the leader),
+/// and every other task waits for its result. If the leader throws or is cancelled, one of the waiters takes over.
+///
+/// Expiry is checked lazily against the same monotonic clock the time driver uses,
+/// so an idle cache never schedules timers or wakes anyone up. When a shard is full,
+/// expired entries are pruned first and then the oldest entries are evicted.
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+struct AsyncCache {
+    static_assert(std::is_copy_constructible_v<V>, "cached values are handed out by copy");
+
+    /// Creates a cache that holds at most `capacity` values (rounded up to a multiple of `shards`),
+    /// each of which stays valid for `ttl` after being inserted.
+    explicit AsyncCache(size_t capacity, asp::time::Duration ttl, size_t shards = 16)
+        : m_ttl(ttl),
+          m_shardCount(std::max<size_t>(shards, 1)),
+          m_shardCapacity(std::max<size_t>((capacity + m_shardCount - 1) / m_shardCount, 1)),
+          m_shards(std::make_unique<Shard[]>(m_shardCount)) {}
+
+    AsyncCache(const AsyncCache&) = delete;
+    AsyncCache& operator=(const AsyncCache&) = delete;
+
+private:
+    /// A single in-flight fetch, shared between the leader and everyone waiting on it
+    struct Flight {
+        enum State : uint8_t {
+            Pending,
+            Done,
+            Abandoned,
+        };
+
+        Notify notify;
+        std::atomic<uint8_t> state{Pending};
+        std::optional<V> value; // written once before `state` becomes Done
+    };
+
+    struct Entry {
+        asp::SharedPtr<Flight> flight; // set while the value is being fetched
+        std::optional<V> value;
+        asp::time::Instant expiry;
+    };
+
+    struct ShardData {
+        std::unordered_map<K, Entry, Hash, Eq> entries;
+        // keys in insertion order, used for eviction. Since the ttl is fixed, this is also expiry order.
+        // may contain stale keys that were removed or reinserted, those are detected by comparing the expiry
+        std::deque<std::pair<K, asp::time::Instant>> order;
+        size_t ready = 0;
+    };
+
+    struct alignas(64) Shard {
+        asp::Mutex<ShardData> data;
+    };
+
+public:
+    template <typename F, typename Fut = std::invoke_result_t<F&, const K&>>
+    struct ARC_NODISCARD GetAwaiter : Pollable<GetAwaiter<F, Fut>, V> {
+        explicit GetAwaiter(AsyncCache& cache, K key, F func)
+            : m_cache(&cache), m_key(std::move(key)), m_func(std::move(func)) {}
+
+        GetAwaiter(GetAwaiter&& other) noexcept(std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<F>)
+            : m_cache(other.m_cache), m_key(std::move(other.m_key)), m_func(std::move(other.m_func))
+        {
+            ARC_ASSERT(other.m_role == Role::None, "cannot move a cache lookup that was already polled");
+        }
+
+        GetAwaiter& operator=(GetAwaiter&&) = delete;
+
+        ~GetAwaiter() {
+            if (m_role == Role::Leader) {
+                // cancelled while fetching
+                m_fut.reset();
+                m_cache->abandon(m_key, m_flight);
+            }
+        }
+
+        std::optional<V> poll(Context& cx) {
+            while (true) {
+                switch (m_role) {
+                    case Role::None: {
+                        if (auto value = this->lookupOrJoin()) {
+                            m_role = Role::Done;
+                            return value;
+                        }
+                    } break;
+
+                    case Role::Leader: {
+                        return this->pollFetch(cx);
+                    } break;
+
+                    case Role::Follower: {
+                        switch (m_flight->state.load(std::memory_order::acquire)) {
+                            case Flight::Done: {
+                                m_role = Role::Done;
+                                return *m_flight->value;
+                            } break;
+
+                            case Flight::Abandoned: {
+                                // the leader is gone, start over and possibly become the new leader
+                                m_notified.reset();
+                                m_flight = nullptr;
+                                m_role = Role::None;
+                                continue;
+                            } break;
+
+                            default: break;
+                        }
+
+                        if (!m_notified->poll(cx)) {
+                            return std::nullopt;
+                        }
+
+                        // the state is always updated before notifying, loop around to read it
+                    } break;
+
+                    default: std::unreachable();
+                }
+            }
+        }
+
+    private:
+        enum class Role : uint8_t {
+            None,
+            Leader,
+            Follower,
+            Done,
+        };
+
+        using FutOut = typename FutureTraits<std::decay_t<Fut>>::Output;
+
+        AsyncCache* m_cache;
+        K m_key;
+        F m_func;
+        asp::SharedPtr<Flight> m_flight;
+        std::optional<Notified> m_notified;
+        std::optional<Fut> m_fut;
+        Role m_role = Role::None;
+
+        /// Returns the cached value if present, otherwise joins the in-flight fetch or starts a new one
+        std::optional<V> lookupOrJoin() {
+            auto now = asp::time::Instant::now();
+
+            {
+                auto shard = m_cache->shardFor(m_key).data.lock();
+                auto it = shard->entries.find(m_key);
+
+                if (it != shard->entries.end()) {
+                    auto& entry = it->second;
+
+                    if (entry.flight) {
+                        // created with the shard locked, so it will observe the leader's notifyAll
+                        m_flight = entry.flight;
+                        m_notified.emplace(m_flight->notify.notified());
+                        m_role = Role::Follower;
+                        return std::nullopt;
+                    }
+
+                    if (entry.expiry > now) {
+                        return *entry.value;
+                    }
+
+                    shard->entries.erase(it);
+                    shard->ready--;
+                }
+
+                m_flight = asp::make_shared<Flight>();
+                shard->entries.emplace(m_key, Entry{m_flight, std::nullopt, now});
+                m_role = Role::Leader;
+            }
+
+            try {
+                m_fut.emplace(std::invoke(m_func, std::as_const(m_key)));
+            } catch (...) {
+                m_role = Role::Done;
+                m_cache->abandon(m_key, m_flight);
+                throw;
+            }
+
+            return std::nullopt;
+        }
+
+        std::optional<V> pollFetch(Context& cx) {
+            auto vt = m_fut->m_vtable;
+            if (!vt->m_poll(&*m_fut, cx)) {
+                return std::nullopt;
+            }
+
+            m_role = Role::Done;
+
+            try {
+                V value = vt->template getOutput<FutOut>(&*m_fut);
+                m_fut.reset();
+                m_cache->complete(m_key, m_flight, value);
+                return value;
+            } catch (...) {
+                m_fut.reset();
+                m_cache->abandon(m_key, m_flight);
+                throw;
+            }
+        }
+    };
+
+    /// Returns the cached value for `key`, or calls `func(key)` and awaits the pollable it returns to fetch it.
+    /// If another task is already fetching the same key, this waits for that fetch instead of calling `func`.
+    template <typename F>
+    GetAwaiter<F> getOrFetch(K key, F func) {
+        return GetAwaiter<F>{*this, std::move(key), std::move(func)};
+    }
+
+    /// Returns the cached value if it is present and not expired, never waits.
+    std::optional<V> get(const K& key) {
+        auto now = asp::time::Instant::now();
+        auto shard = this->shardFor(key).data.lock();
+
+        auto it = shard->entries.find(key);
+        if (it == shard->entries.end() || it->second.flight || it->second.expiry <= now) {
+            return std::nullopt;
+        }
+
+        return *it->second.value;
+    }
+
+    /// Inserts or replaces a value. An in-flight fetch for the same key will not overwrite it.
+    void insert(const K& key, V value) {
+        auto shard = this->shardFor(key).data.lock();
+        this->insertLocked(*shard, key, std::move(value));
+    }
+
+    /// Removes the value for `key`. An in-flight fetch is not interrupted, but its result will not be cached.
+    void invalidate(const K& key) {
+        auto shard = this->shardFor(key).data.lock();
+
+        auto it = shard->entries.find(key);
+        if (it == shard->entries.end()) return;
+
+        if (!it->second.flight) {
+            shard->ready--;
+        }
+
+        shard->entries.erase(it);
+    }
+
+    /// Returns the number of cached values, including ones that have expired but were not pruned yet.
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < m_shardCount; i++) {
+            total += m_shards[i].data.lock()->ready;
+        }
+        return total;
+    }
+
+private:
+    asp::time::Duration m_ttl;
+    size_t m_shardCount;
+    size_t m_shardCapacity;
+    std::unique_ptr<Shard[]> m_shards;
+
+    Shard& shardFor(const K& key) const {
+        return m_shards[Hash{}(key) % m_shardCount];
+    }
+
+    void insertLocked(ShardData& shard, const K& key, V value) {
+        auto expiry = asp::time::Instant::now() + m_ttl;
+
+        auto [it, inserted] = shard.entries.try_emplace(key);
+        if (inserted || it->second.flight) {
+            shard.ready++;
+        }
+
+        it->second = Entry{nullptr, std::move(value), expiry};
+        shard.order.emplace_back(key, expiry);
+
+        this->evict(shard);
+    }
+
+    void evict(ShardData& shard) {
+        auto now = asp::time::Instant::now();
+
+        while (!shard.order.empty()) {
+            auto& [key, expiry] = shard.order.front();
+            bool full = shard.ready > m_shardCapacity;
+
+            if (!full && expiry > now) {
+                break;
+            }
+
+            // only evict if the entry wasn't replaced or removed since
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end() && !it->second.flight && it->second.expiry == expiry) {
+                shard.entries.erase(it);
+                shard.ready--;
+            }
+
+            shard.order.pop_front();
+        }
+    }
+
+    void complete(const K& key, const asp::SharedPtr<Flight>& flight, const V& value) {
+        {
+            auto shard = this->shardFor(key).data.lock();
+
+            // if the key was invalidated in the meantime, don't cache the result
+            auto it = shard->entries.find(key);
+            if (it != shard->entries.end() && it->second.flight.get() == flight.get()) {
+                shard->entries.erase(it);
+                this->insertLocked(*shard, key, value);
+            }
+        }
+
+        flight->value.emplace(value);
+        flight->state.store(Flight::Done, std::memory_order::release);
+        flight->notify.notifyAll();
+    }
+
+    void abandon(const K& key, const asp::SharedPtr<Flight>& flight) noexcept {
+        {
+            auto shard = this->shardFor(key).data.lock();
+
+            auto it = shard->entries.find(key);
+            if (it != shard->entries.end() && it->second.flight.get() == flight.get()) {
+                shard->entries.erase(it);
+            }
+        }
+
+        flight->state.store(Flight::Abandoned, std::memory_order::release);
+        flight->notify.notifyAll();
+    }
+};
+
+}
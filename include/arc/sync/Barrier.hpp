@@ -0,0 +1,66 @@
+#pragma once
+
+#include <arc/future/Pollable.hpp>
+#include <arc/task/WaitList.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <atomic>
+#include <cstddef>
+
+namespace arc {
+
+struct BarrierWaitResult {
+    /// Whether this task was the one that completed the barrier. Exactly one task per generation is the leader.
+    bool isLeader;
+};
+
+/// A reusable barrier that lets a fixed number of tasks rendezvous.
+/// Once `n` tasks have called `wait()`, all of them are released at once, and the barrier resets for the next generation.
+struct Barrier {
+    explicit Barrier(size_t n);
+
+    Barrier(const Barrier&) = delete;
+    Barrier& operator=(const Barrier&) = delete;
+
+    struct ARC_NODISCARD Awaiter : Pollable<Awaiter, BarrierWaitResult>, WaitListNode {
+        explicit Awaiter(Barrier& barrier) noexcept : m_barrier(&barrier) {}
+
+        Awaiter(Awaiter&&) noexcept;
+        Awaiter& operator=(Awaiter&&) noexcept = delete;
+        ~Awaiter();
+
+        std::optional<BarrierWaitResult> poll(Context& cx);
+
+    private:
+        friend struct Barrier;
+
+        enum class State : uint8_t {
+            Init,
+            Waiting,
+            Done,
+        };
+
+        Barrier* m_barrier;
+        size_t m_generation = 0;
+        State m_state = State::Init;
+    };
+
+    /// Waits until all `n` tasks have reached the barrier.
+    /// If the awaiter is dropped before the barrier completes, its arrival is withdrawn.
+    Awaiter wait() noexcept;
+
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+private:
+    struct State {
+        size_t arrived = 0;
+        WaitList<Awaiter> waiters;
+    };
+
+    size_t m_size;
+    std::atomic<size_t> m_generation{0}; // only modified with m_state locked
+    asp::Mutex<State> m_state;
+};
+
+}
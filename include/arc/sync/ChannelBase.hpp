@@ -4,6 +4,7 @@
 #include <deque>
 #include <optional>
 #include <cstddef>
+#include <cstdint>
 
 namespace arc::chan {
 
@@ -28,6 +29,13 @@ enum class TryRecvOutcome {
     Closed
 };
 
+/// State of a receiver that can have a value delivered directly into it
+enum class RecvState : uint8_t {
+    Init,
+    Waiting,
+    Delivered,
+};
+
 template <typename T, typename SendAwaiter, typename RecvAwaiter>
 struct MpscStorage {
     static constexpr bool NoexceptMovable = std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
@@ -125,52 +133,4 @@ private:
     }
 };
 
-template <typename T, typename RecvAwaiter>
-struct OneshotStorage {
-    static constexpr bool NoexceptMovable = std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
-
-    explicit OneshotStorage() {}
-
-    std::optional<T> value;
-    RecvAwaiter* recvWaiter = nullptr;
-
-    bool hasCapacity() const noexcept {
-        // it is undefined behavior to interact with oneshot after a value has been sent,
-        // so this check realistically will always be 'true' for all valid uses.
-        return true;
-    }
-
-    void registerRecvWaiter(RecvAwaiter* waiter) noexcept {
-        recvWaiter = waiter;
-    }
-
-    /// Returns the value, if present.
-    std::optional<T> pop() noexcept(NoexceptMovable) {
-        if (value) {
-            return std::move(*value);
-        }
-        return std::nullopt;
-    }
-
-    /// Attempts to push a value directly into the receiver's slot if one is present, otherwise stores it.
-    void push(T& value) noexcept(NoexceptMovable) {
-        if (this->deliverToReceiver(value)) {
-            return;
-        }
-
-        ARC_DEBUG_ASSERT(!this->value.has_value() && "Pushing to a oneshot channel that already has a value!");
-        this->value = std::move(value);
-    }
-
-private:
-    bool deliverToReceiver(T& value) noexcept(NoexceptMovable) {
-        if (recvWaiter && recvWaiter->tryDeliver(value)) {
-            recvWaiter = nullptr;
-            return true;
-        }
-
-        return false;
-    }
-};
-
 }
\ No newline at end of file
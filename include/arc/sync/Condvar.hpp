@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Mutex.hpp"
+#include <arc/task/WaitList.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <atomic>
+#include <optional>
+
+namespace arc {
+
+/// Node registered in a Condvar's wait list
+struct CondvarWaiter : WaitListNode {
+    CondvarWaiter() noexcept = default;
+    CondvarWaiter(CondvarWaiter&&) noexcept : WaitListNode() {}
+
+protected:
+    friend struct Condvar;
+    std::atomic<bool> m_notified{false};
+};
+
+/// An asynchronous condition variable, to be used together with `arc::Mutex`.
+/// `wait(guard)` registers the task as a waiter before unlocking the mutex, so a notification sent by a task
+/// that acquires the mutex afterwards is never lost. Like any condition variable, the predicate should be rechecked after waking:
+///
+/// ```cpp
+/// auto guard = co_await mtx.lock();
+/// while (guard->empty()) {
+///     guard = co_await cv.wait(std::move(guard));
+/// }
+/// ```
+struct Condvar {
+    Condvar() noexcept = default;
+    Condvar(const Condvar&) = delete;
+    Condvar& operator=(const Condvar&) = delete;
+
+    template <typename T, typename Mtx>
+    struct ARC_NODISCARD WaitAwaiter : Pollable<WaitAwaiter<T, Mtx>, MutexGuard<T, Mtx>>, CondvarWaiter {
+        using Guard = MutexGuard<T, Mtx>;
+
+        explicit WaitAwaiter(Condvar& cv, Guard guard, Mtx* mtx) noexcept
+            : m_cv(&cv), m_mtx(mtx), m_guard(std::move(guard)) {}
+
+        WaitAwaiter(WaitAwaiter&& other) noexcept
+            : CondvarWaiter(std::move(other)),
+              m_cv(other.m_cv),
+              m_mtx(other.m_mtx),
+              m_guard(std::move(other.m_guard))
+        {
+            ARC_ASSERT(other.m_state == State::Init, "cannot move a Condvar awaiter that was already polled");
+        }
+
+        WaitAwaiter& operator=(WaitAwaiter&&) = delete;
+
+        ~WaitAwaiter() {
+            if (m_state == State::Waiting) {
+                m_cv->unregister(this);
+            }
+        }
+
+        std::optional<Guard> poll(Context& cx) {
+            while (true) {
+                switch (m_state) {
+                    case State::Init: {
+                        // register first and only then unlock, this way no notification can slip in between
+                        m_cv->registerWaiter(this, cx);
+                        m_state = State::Waiting;
+                        m_guard.reset();
+                    } break;
+
+                    case State::Waiting: {
+                        if (!m_notified.load(std::memory_order::acquire)) {
+                            return std::nullopt;
+                        }
+
+                        m_state = State::Locking;
+                        m_lock.emplace(m_mtx->lock());
+                    } break;
+
+                    case State::Locking: {
+                        return m_lock->poll(cx);
+                    } break;
+
+                    default: std::unreachable();
+                }
+            }
+        }
+
+    private:
+        enum class State : uint8_t {
+            Init,
+            Waiting,
+            Locking,
+        };
+
+        Condvar* m_cv;
+        Mtx* m_mtx;
+        std::optional<Guard> m_guard;
+        std::optional<typename Mtx::LockAwaiter> m_lock;
+        State m_state = State::Init;
+    };
+
+    /// Unlocks the mutex and waits until notified, then locks the mutex again and returns the new guard.
+    /// The guard must be valid and belong to the mutex that protects the awaited condition.
+    template <typename T, typename Mtx>
+    WaitAwaiter<T, Mtx> wait(MutexGuard<T, Mtx> guard) noexcept {
+        Mtx* mtx = guard.m_mtx;
+        ARC_ASSERT(mtx, "Condvar::wait called with an empty guard");
+        return WaitAwaiter<T, Mtx>{*this, std::move(guard), mtx};
+    }
+
+    /// Wakes up one waiting task, does nothing if nobody is waiting.
+    void notifyOne() noexcept;
+
+    /// Wakes up all waiting tasks at once.
+    void notifyAll() noexcept;
+
+private:
+    // only modified with m_waiters locked, lets notify skip the lock when nobody is waiting
+    std::atomic<size_t> m_waiting{0};
+    asp::Mutex<WaitList<CondvarWaiter>> m_waiters;
+
+    void registerWaiter(CondvarWaiter* waiter, Context& cx);
+    void unregister(CondvarWaiter* waiter) noexcept;
+};
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <arc/future/Pollable.hpp>
+#include <arc/task/WaitList.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <atomic>
+#include <cstddef>
+
+namespace arc {
+
+/// A single-use countdown latch. Tasks can wait until the counter reaches zero,
+/// at which point all of them are released at once. Unlike a Barrier, a Latch cannot be reused.
+struct Latch {
+    explicit Latch(size_t count);
+
+    Latch(const Latch&) = delete;
+    Latch& operator=(const Latch&) = delete;
+
+    struct ARC_NODISCARD Awaiter : Pollable<Awaiter>, WaitListNode {
+        explicit Awaiter(Latch& latch) noexcept : m_latch(&latch) {}
+
+        Awaiter(Awaiter&&) noexcept;
+        Awaiter& operator=(Awaiter&&) noexcept = delete;
+        ~Awaiter();
+
+        bool poll(Context& cx);
+
+    private:
+        Latch* m_latch;
+        bool m_registered = false;
+    };
+
+    /// Decrements the counter by `n`, releasing all waiters if it reaches zero.
+    /// Counting down past zero is a logic error.
+    void countDown(size_t n = 1) noexcept;
+
+    /// Waits until the counter reaches zero. Completes immediately if it already has.
+    Awaiter wait() noexcept;
+
+    /// Decrements the counter by one and then waits for it to reach zero.
+    Awaiter arriveAndWait() noexcept;
+
+    /// Returns whether the counter has reached zero, without waiting.
+    bool tryWait() const noexcept;
+
+    size_t count() const noexcept;
+
+private:
+    std::atomic<size_t> m_count;
+    asp::Mutex<WaitList<Awaiter>> m_waiters;
+};
+
+}
@@ -11,6 +11,8 @@ namespace arc {
 template <typename T>
 struct Mutex;
 
+struct Condvar;
+
 template <typename T = void, typename Mtx = Mutex<T>>
 struct MutexGuard {
     ~MutexGuard() {
@@ -37,6 +39,8 @@ struct MutexGuard {
     }
 
 private:
+    friend struct Condvar;
+
     Mtx* m_mtx = nullptr;
 };
 
@@ -45,12 +49,43 @@ struct Mutex {
     using T = std::conditional_t<std::is_void_v<RawT>, std::monostate, RawT>;
     using Guard = MutexGuard<T, Mutex<RawT>>;
 
-    explicit Mutex(T value) : m_value(std::move(value)), m_sema(1) {}
+    explicit Mutex(T value, Fairness fairness = Fairness::Fair) : m_value(std::move(value)), m_sema(1, fairness) {}
     explicit Mutex() : m_value(), m_sema(1) {}
+    explicit Mutex(Fairness fairness) : m_value(), m_sema(1, fairness) {}
+
+    struct ARC_NODISCARD LockAwaiter : Pollable<LockAwaiter, Guard> {
+        explicit LockAwaiter(Mutex& mtx) noexcept : m_mtx(&mtx), m_acquire(mtx.m_sema.acquire()) {}
+
+        std::optional<Guard> poll(Context& cx) {
+            // fast path, try to grab the permit without touching the wait list
+            if (!m_polled) {
+                if (!cx.pollBudget()) {
+                    return std::nullopt;
+                }
+
+                m_polled = true;
+
+                if (m_mtx->m_sema.tryAcquire()) {
+                    return Guard{m_mtx};
+                }
+            }
+
+            if (m_acquire.poll(cx)) {
+                return Guard{m_mtx};
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        Mutex* m_mtx;
+        Semaphore::AcquireAwaiter m_acquire;
+        bool m_polled = false;
+    };
 
-    arc::Future<Guard> lock() noexcept {
-        co_await m_sema.acquire();
-        co_return Guard{this};
+    /// Locks the mutex, waiting if it's currently held. Does not allocate.
+    LockAwaiter lock() noexcept {
+        return LockAwaiter{*this};
     }
 
     Guard blockingLock() noexcept {
@@ -11,21 +11,32 @@ namespace arc {
 struct Notified;
 
 struct NotifyState {
+    static constexpr size_t PERMIT_BIT = 1 << 0;
+    static constexpr size_t WAITERS_BIT = 1 << 1;
+    static constexpr size_t EPOCH_ONE = 1 << 2;
+    static constexpr size_t EPOCH_MASK = ~(PERMIT_BIT | WAITERS_BIT);
+
+    /// Packed state: stored permit bit, has-waiters bit, and the notifyAll epoch in the remaining bits.
+    /// The waiters bit is only ever changed with m_waiters locked.
+    std::atomic<size_t> m_state{0};
     asp::Mutex<WaitList<Notified>> m_waiters;
-    bool m_storedPermit = false; // also guarded by m_waiters
 
-    bool claimStoredOrRegister(Notified* notified, Context& cx);
+    size_t epoch() const noexcept;
+
+    /// Lock-free check, returns true if a notifyAll happened since `epoch` or if a stored permit was claimed
+    bool tryClaim(size_t epoch) noexcept;
+    bool claimOrRegister(Notified* notified, Context& cx);
     void unregister(Notified* notified);
 };
 
-struct ARC_NODISCARD Notified : Pollable<Notified> {
+struct ARC_NODISCARD Notified : Pollable<Notified>, WaitListNode {
     enum class State : uint8_t {
         Init,
         Waiting,
         Notified,
     };
 
-    explicit Notified(asp::SharedPtr<NotifyState> state) noexcept : m_notify(std::move(state)) {}
+    explicit Notified(asp::SharedPtr<NotifyState> state) noexcept;
 
     // Because atomic cannot be moved, we must manually define move constructors
     Notified(Notified&&) noexcept;
@@ -38,12 +49,15 @@ struct ARC_NODISCARD Notified : Pollable<Notified> {
 
 private:
     friend class Notify;
+    friend struct NotifyState;
     asp::SharedPtr<NotifyState> m_notify;
     std::atomic<State> m_waitState{State::Init};
+    size_t m_epoch;
 };
 
 /// Synchronization primitive that allows a task to wait for notifications, be it from another task or synchronous code.
 /// Notify can safely be copied around, and it will still reference the same internal state.
+/// Neither `notified()` nor the notify functions take a lock unless there are waiters registered.
 class Notify {
 public:
     Notify();
@@ -59,6 +73,7 @@ public:
     void notifyOne(bool store = true) const;
 
     /// Notifies all waiters, no permits are stored.
+    /// This also completes every `Notified` that was created before this call, even if it was not polled yet.
     void notifyAll() const;
 
 private:
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <arc/future/Pollable.hpp>
+#include <arc/task/WaitList.hpp>
+#include <arc/util/MaybeUninit.hpp>
+#include <arc/util/Assert.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+
+namespace arc {
+
+/// A cell that is written at most once, intended for lazily initialized shared state.
+/// When multiple tasks call `getOrInit()` concurrently, only one of them runs the initializer,
+/// while the rest wait until it finishes. If the initializer throws or is cancelled,
+/// the cell goes back to being uninitialized, and one of the waiting tasks takes over.
+/// Once initialized, `get()` is a single atomic load.
+template <typename T>
+struct OnceCell {
+    OnceCell() noexcept = default;
+
+    OnceCell(const OnceCell&) = delete;
+    OnceCell& operator=(const OnceCell&) = delete;
+
+    ~OnceCell() {
+        if (m_state.load(std::memory_order::acquire) == Ready) {
+            m_value.drop();
+        }
+    }
+
+    template <typename F, typename Fut = std::invoke_result_t<F&>>
+    struct ARC_NODISCARD InitAwaiter : Pollable<InitAwaiter<F, Fut>, std::reference_wrapper<T>>, WaitListNode {
+        explicit InitAwaiter(OnceCell& cell, F func) : m_cell(&cell), m_func(std::move(func)) {}
+
+        InitAwaiter(InitAwaiter&& other) noexcept(std::is_nothrow_move_constructible_v<F>)
+            : m_cell(other.m_cell), m_func(std::move(other.m_func))
+        {
+            ARC_ASSERT(other.m_role == Role::None, "cannot move a OnceCell awaiter that was already polled");
+        }
+
+        InitAwaiter& operator=(InitAwaiter&&) = delete;
+
+        ~InitAwaiter() {
+            switch (m_role) {
+                case Role::Initializer: {
+                    // cancelled in the middle of initialization, let someone else take over
+                    m_fut.reset();
+                    m_cell->abandon();
+                } break;
+
+                case Role::Waiter: {
+                    m_cell->m_waiters.lock()->remove(this);
+                } break;
+
+                default: break;
+            }
+        }
+
+        std::optional<std::reference_wrapper<T>> poll(Context& cx) {
+            while (true) {
+                switch (m_role) {
+                    case Role::None: {
+                        if (auto value = m_cell->get()) {
+                            return std::ref(*value);
+                        }
+
+                        if (m_cell->tryBeginInit()) {
+                            try {
+                                m_fut.emplace(std::invoke(m_func));
+                            } catch (...) {
+                                m_role = Role::Done;
+                                m_cell->abandon();
+                                throw;
+                            }
+
+                            m_role = Role::Initializer;
+                            continue;
+                        }
+
+                        m_role = Role::Waiter;
+                        continue;
+                    } break;
+
+                    case Role::Initializer: {
+                        return this->pollInit(cx);
+                    } break;
+
+                    case Role::Waiter: {
+                        if (auto value = m_cell->get()) {
+                            return std::ref(*value);
+                        }
+
+                        auto waiters = m_cell->m_waiters.lock();
+                        uint8_t state = m_cell->m_state.load(std::memory_order::acquire);
+
+                        if (state == Initializing) {
+                            // (re)register, we might have been woken by an initializer that gave up
+                            if (!this->isLinked()) {
+                                waiters->add(*cx.waker(), this);
+                            }
+                            return std::nullopt;
+                        }
+
+                        waiters->remove(this);
+                        m_role = Role::None;
+                    } break;
+
+                    default: std::unreachable();
+                }
+            }
+        }
+
+    private:
+        enum class Role : uint8_t {
+            None,
+            Initializer,
+            Waiter,
+            Done,
+        };
+
+        using FutOut = typename FutureTraits<std::decay_t<Fut>>::Output;
+
+        OnceCell* m_cell;
+        F m_func;
+        std::optional<Fut> m_fut;
+        Role m_role = Role::None;
+
+        std::optional<std::reference_wrapper<T>> pollInit(Context& cx) {
+            auto vt = m_fut->m_vtable;
+            if (!vt->m_poll(&*m_fut, cx)) {
+                return std::nullopt;
+            }
+
+            try {
+                T& value = m_cell->finishInit(vt->template getOutput<FutOut>(&*m_fut));
+                m_role = Role::Done;
+                m_fut.reset();
+                return std::ref(value);
+            } catch (...) {
+                m_role = Role::Done;
+                m_fut.reset();
+                m_cell->abandon();
+                throw;
+            }
+        }
+    };
+
+    /// Returns a pointer to the value, or nullptr if the cell is not initialized yet. This never blocks.
+    T* get() noexcept {
+        if (m_state.load(std::memory_order::acquire) == Ready) {
+            return &m_value.assumeInit();
+        }
+
+        return nullptr;
+    }
+
+    const T* get() const noexcept {
+        return const_cast<OnceCell*>(this)->get();
+    }
+
+    bool isInitialized() const noexcept {
+        return m_state.load(std::memory_order::acquire) == Ready;
+    }
+
+    /// Returns the value if initialized, otherwise calls `func` and awaits the pollable it returns to initialize the cell.
+    /// `func` is only called if this task ends up being the initializer.
+    template <typename F>
+    InitAwaiter<F> getOrInit(F func) {
+        return InitAwaiter<F>{*this, std::move(func)};
+    }
+
+    /// Initializes the cell with the given value. Returns false if it is already initialized or being initialized.
+    bool set(T value) {
+        if (!this->tryBeginInit()) {
+            return false;
+        }
+
+        try {
+            this->finishInit(std::move(value));
+        } catch (...) {
+            this->abandon();
+            throw;
+        }
+
+        return true;
+    }
+
+private:
+    static constexpr uint8_t Uninit = 0;
+    static constexpr uint8_t Initializing = 1;
+    static constexpr uint8_t Ready = 2;
+
+    std::atomic<uint8_t> m_state{Uninit};
+    MaybeUninit<T> m_value;
+    asp::Mutex<WaitList<WaitListNode>> m_waiters;
+
+    bool tryBeginInit() noexcept {
+        uint8_t expected = Uninit;
+        return m_state.compare_exchange_strong(expected, Initializing, std::memory_order::acq_rel, std::memory_order::acquire);
+    }
+
+    T& finishInit(T&& value) {
+        m_value.init(std::move(value));
+        m_state.store(Ready, std::memory_order::release);
+        this->wakeAll();
+        return m_value.assumeInit();
+    }
+
+    void abandon() noexcept {
+        m_state.store(Uninit, std::memory_order::release);
+        this->wakeAll();
+    }
+
+    void wakeAll() noexcept {
+        m_waiters.lock()->forAll([](Waker& waker, WaitListNode*) {
+            waker.wake();
+        });
+    }
+};
+
+}
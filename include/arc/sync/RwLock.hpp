@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Semaphore.hpp"
+#include <type_traits>
+#include <variant>
+#include <optional>
+#include <limits>
+
+namespace arc {
+
+template <typename T>
+struct RwLock;
+
+template <typename T, typename Lock>
+struct RwLockReadGuard {
+    ~RwLockReadGuard() {
+        if (m_lock) m_lock->m_sema.release(1);
+    }
+
+    const T& operator*() const noexcept {
+        return m_lock->m_value;
+    }
+
+    const T* operator->() const noexcept {
+        return &m_lock->m_value;
+    }
+
+    RwLockReadGuard(const Lock* lock) : m_lock(lock) {}
+    RwLockReadGuard(const RwLockReadGuard&) = delete;
+    RwLockReadGuard& operator=(const RwLockReadGuard&) = delete;
+    RwLockReadGuard(RwLockReadGuard&& other) noexcept : m_lock(std::exchange(other.m_lock, nullptr)) {}
+    RwLockReadGuard& operator=(RwLockReadGuard&& other) noexcept {
+        if (this != &other) {
+            if (m_lock) m_lock->m_sema.release(1);
+            m_lock = std::exchange(other.m_lock, nullptr);
+        }
+        return *this;
+    }
+
+private:
+    const Lock* m_lock = nullptr;
+};
+
+template <typename T, typename Lock>
+struct RwLockWriteGuard {
+    ~RwLockWriteGuard() {
+        if (m_lock) m_lock->m_sema.release(Lock::MaxReaders);
+    }
+
+    T& operator*() noexcept {
+        return m_lock->m_value;
+    }
+
+    T* operator->() noexcept {
+        return &m_lock->m_value;
+    }
+
+    RwLockWriteGuard(Lock* lock) : m_lock(lock) {}
+    RwLockWriteGuard(const RwLockWriteGuard&) = delete;
+    RwLockWriteGuard& operator=(const RwLockWriteGuard&) = delete;
+    RwLockWriteGuard(RwLockWriteGuard&& other) noexcept : m_lock(std::exchange(other.m_lock, nullptr)) {}
+    RwLockWriteGuard& operator=(RwLockWriteGuard&& other) noexcept {
+        if (this != &other) {
+            if (m_lock) m_lock->m_sema.release(Lock::MaxReaders);
+            m_lock = std::exchange(other.m_lock, nullptr);
+        }
+        return *this;
+    }
+
+private:
+    Lock* m_lock = nullptr;
+};
+
+/// An asynchronous reader-writer lock. Allows any number of concurrent readers or a single writer.
+/// It is built on top of a semaphore with `MaxReaders` permits, where a reader takes one permit
+/// and a writer takes all of them. Since the semaphore hands out permits in FIFO order,
+/// a waiting writer blocks any readers that arrive after it, meaning writers cannot get starved.
+template <typename RawT = void>
+struct RwLock {
+    using T = std::conditional_t<std::is_void_v<RawT>, std::monostate, RawT>;
+    using ReadGuard = RwLockReadGuard<T, RwLock<RawT>>;
+    using WriteGuard = RwLockWriteGuard<T, RwLock<RawT>>;
+
+    static constexpr size_t MaxReaders = std::numeric_limits<uint32_t>::max() >> 3;
+
+    explicit RwLock(T value) : m_value(std::move(value)), m_sema(MaxReaders) {}
+    explicit RwLock() : m_value(), m_sema(MaxReaders) {}
+
+    template <typename Guard, size_t Permits>
+    struct ARC_NODISCARD LockAwaiter : Pollable<LockAwaiter<Guard, Permits>, Guard> {
+        explicit LockAwaiter(RwLock& lock) noexcept : m_lock(&lock), m_acquire(lock.m_sema.acquire(Permits)) {}
+
+        std::optional<Guard> poll(Context& cx) {
+            // fast path, try to grab the permits without touching the wait list
+            if (!m_polled) {
+                if (!cx.pollBudget()) {
+                    return std::nullopt;
+                }
+
+                m_polled = true;
+
+                if (m_lock->m_sema.tryAcquire(Permits)) {
+                    return Guard{m_lock};
+                }
+            }
+
+            if (m_acquire.poll(cx)) {
+                return Guard{m_lock};
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        RwLock* m_lock;
+        Semaphore::AcquireAwaiter m_acquire;
+        bool m_polled = false;
+    };
+
+    using ReadAwaiter = LockAwaiter<ReadGuard, 1>;
+    using WriteAwaiter = LockAwaiter<WriteGuard, MaxReaders>;
+
+    /// Locks the lock for reading, waiting if a writer holds it or is queued.
+    ReadAwaiter read() noexcept {
+        return ReadAwaiter{*this};
+    }
+
+    /// Locks the lock for writing, waiting until all readers and writers release it.
+    WriteAwaiter write() noexcept {
+        return WriteAwaiter{*this};
+    }
+
+    ReadGuard blockingRead() noexcept {
+        m_sema.acquireBlocking(1);
+        return ReadGuard{this};
+    }
+
+    WriteGuard blockingWrite() noexcept {
+        m_sema.acquireBlocking(MaxReaders);
+        return WriteGuard{this};
+    }
+
+    std::optional<ReadGuard> tryRead() noexcept {
+        if (m_sema.tryAcquire(1)) {
+            return ReadGuard{this};
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<WriteGuard> tryWrite() noexcept {
+        if (m_sema.tryAcquire(MaxReaders)) {
+            return WriteGuard{this};
+        } else {
+            return std::nullopt;
+        }
+    }
+
+private:
+    friend struct RwLockReadGuard<T, RwLock<RawT>>;
+    friend struct RwLockWriteGuard<T, RwLock<RawT>>;
+
+    T m_value;
+    mutable Semaphore m_sema;
+};
+
+}
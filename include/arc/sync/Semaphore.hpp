@@ -8,10 +8,24 @@
 
 namespace arc {
 
+/// Determines how a semaphore hands out released permits when tasks are waiting.
+enum class Fairness : uint8_t {
+    /// Permits are handed directly to waiters in FIFO order. Nobody can jump the queue,
+    /// but every release under contention has to wait for the woken task to get scheduled.
+    Fair,
+    /// Permits go back to the semaphore and waiters are only signalled, whoever polls first gets them.
+    /// This allows a task to reacquire right after releasing, which increases throughput under high contention.
+    /// A waiter that loses the race `Semaphore::MAX_BARGES` times gets the next permits handed to it directly.
+    Barging,
+};
+
 struct Semaphore {
-    explicit Semaphore(size_t permits);
+    /// How many times a waiter can lose to barging tasks before permits are handed to it directly
+    static constexpr size_t MAX_BARGES = 4;
+
+    explicit Semaphore(size_t permits, Fairness fairness = Fairness::Fair);
 
-    struct ARC_NODISCARD AcquireAwaiter : Pollable<AcquireAwaiter> {
+    struct ARC_NODISCARD AcquireAwaiter : Pollable<AcquireAwaiter>, WaitListNode {
         explicit AcquireAwaiter(Semaphore& sem, size_t permits) : m_sem(sem), m_requested(permits) {}
 
         bool poll(Context& cx);
@@ -25,6 +39,8 @@ struct Semaphore {
         friend struct Semaphore;
         Semaphore& m_sem;
         bool m_registered = false;
+        bool m_woken = false; // signalled by a barging release, must compete for the permits
+        uint8_t m_barged = 0;
         size_t m_acquired = 0;
         size_t m_requested;
         asp::SpinLock<> m_lock;
@@ -38,21 +54,28 @@ struct Semaphore {
 
     size_t permits() const noexcept;
 
+    /// Returns whether any task is currently waiting for permits.
+    bool hasWaiters() const noexcept;
+
 private:
     template <typename T>
     friend struct Mutex;
 
-    struct Waiter {
-        Waker waker;
-        AcquireAwaiter* awaiter;
-    };
-
+    Fairness m_fairness;
     std::atomic<size_t> m_permits;
+    // number of registered waiters, lets release() skip the lock when nobody is waiting. only incremented with m_waiters locked
+    std::atomic<size_t> m_waiting{0};
     asp::Mutex<WaitList<AcquireAwaiter>> m_waiters;
 
     /// Acquires from 0 to n permits, returning the acquired amount
-    size_t tryAcquireOrRegister(size_t maxp, Context& cx, AcquireAwaiter* awaiter);
+    size_t tryAcquireOrRegister(size_t maxp, Context& cx, AcquireAwaiter* awaiter, bool front = false);
     bool assignPermitsTo(size_t& remaining, AcquireAwaiter* waiter);
+    void assignPermits(WaitList<AcquireAwaiter>& waiters, size_t n) noexcept;
+    void signalWaiters(WaitList<AcquireAwaiter>& waiters, size_t n) noexcept;
+    void distribute(WaitList<AcquireAwaiter>& waiters, size_t n) noexcept;
+    /// Hands permits sitting in the counter to registered waiters that may have missed them.
+    /// Only takes out as many as the waiters still need, so concurrent try-acquires are not starved meanwhile.
+    void handOffAvailable(WaitList<AcquireAwaiter>& waiters) noexcept;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Semaphore.hpp"
+#include <memory>
+#include <optional>
+
+namespace arc {
+
+/// A semaphore for hot, widely shared concurrency limits.
+/// Every thread keeps a small cache of permits in its own shard, so uncontended acquires and releases
+/// only touch a thread-local cache line. Shards refill from and spill back into a global `Semaphore` in batches,
+/// and once any task has to wait, cached permits are flushed to the global pool so waiters cannot be starved by idle caches.
+///
+/// Up to `shards * 2 * batch` permits can sit in caches at any given moment,
+/// so this is best suited for limits that are large compared to the batch size.
+struct ShardedSemaphore {
+    explicit ShardedSemaphore(size_t permits, size_t batch = 16);
+
+    ShardedSemaphore(const ShardedSemaphore&) = delete;
+    ShardedSemaphore& operator=(const ShardedSemaphore&) = delete;
+
+    struct ARC_NODISCARD AcquireAwaiter : Pollable<AcquireAwaiter> {
+        explicit AcquireAwaiter(ShardedSemaphore& sem, size_t permits) noexcept : m_sem(&sem), m_permits(permits) {}
+        AcquireAwaiter(AcquireAwaiter&&) noexcept = default;
+        AcquireAwaiter& operator=(AcquireAwaiter&&) noexcept = delete;
+
+        bool poll(Context& cx);
+
+    private:
+        ShardedSemaphore* m_sem;
+        size_t m_permits;
+        std::optional<Semaphore::AcquireAwaiter> m_slow;
+    };
+
+    AcquireAwaiter acquire(size_t permits = 1) noexcept;
+    bool tryAcquire(size_t permits = 1) noexcept;
+    void release(size_t permits = 1) noexcept;
+
+    /// Returns the number of permits that are not currently acquired, including the cached ones. This is only an estimate.
+    size_t permits() const noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<size_t> cached{0};
+    };
+
+    Semaphore m_global;
+    size_t m_batch;
+    size_t m_shardCount;
+    std::unique_ptr<Shard[]> m_shards;
+
+    Shard& localShard() const noexcept;
+    void flushShard(Shard& shard) noexcept;
+    void flushAll() noexcept;
+};
+
+}
@@ -0,0 +1,584 @@
+#pragma once
+#include <arc/future/Pollable.hpp>
+#include <arc/task/Waker.hpp>
+#include <arc/task/WaitList.hpp>
+#include <arc/util/MaybeUninit.hpp>
+#include <arc/util/Trace.hpp>
+#include <asp/sync/Mutex.hpp>
+#include "ChannelBase.hpp"
+#include <atomic>
+#include <memory>
+
+namespace arc::mpmc {
+
+using namespace arc::chan;
+
+template <typename T>
+struct SendAwaiter;
+template <typename T>
+struct RecvAwaiter;
+
+enum class WaitState : uint8_t {
+    Init,
+    Waiting,
+    Notified,
+    Done,
+};
+
+/// Bounded lock-free multi-producer, multi-consumer queue (Dmitry Vyukov's algorithm).
+/// Every slot carries a sequence number that tells producers and consumers whether it's free or filled,
+/// so both ends only ever need a single CAS on their own index.
+template <typename T>
+struct RingBuffer {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "mpmc channel values must be nothrow move constructible");
+
+    explicit RingBuffer(size_t capacity) : m_capacity(capacity), m_slots(std::make_unique<Slot[]>(capacity)) {
+        for (size_t i = 0; i < capacity; i++) {
+            m_slots[i].seq.store(i, std::memory_order::relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    ~RingBuffer() {
+        while (this->pop()) {}
+    }
+
+    /// Moves the value into the queue, returns false if the queue is full (value is left untouched in that case)
+    bool push(T& value) noexcept {
+        size_t pos = m_tail.load(std::memory_order::relaxed);
+
+        while (true) {
+            Slot& slot = m_slots[pos % m_capacity];
+            size_t seq = slot.seq.load(std::memory_order::acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+                    slot.value.init(std::move(value));
+                    slot.seq.store(pos + 1, std::memory_order::release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = m_tail.load(std::memory_order::relaxed);
+            }
+        }
+    }
+
+    std::optional<T> pop() noexcept {
+        size_t pos = m_head.load(std::memory_order::relaxed);
+
+        while (true) {
+            Slot& slot = m_slots[pos % m_capacity];
+            size_t seq = slot.seq.load(std::memory_order::acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+                    std::optional<T> out{std::move(slot.value.assumeInit())};
+                    slot.value.drop();
+                    slot.seq.store(pos + m_capacity, std::memory_order::release);
+                    return out;
+                }
+            } else if (diff < 0) {
+                return std::nullopt; // empty
+            } else {
+                pos = m_head.load(std::memory_order::relaxed);
+            }
+        }
+    }
+
+    /// Returns the approximate amount of values in the queue
+    size_t size() const noexcept {
+        size_t head = m_head.load(std::memory_order::acquire);
+        size_t tail = m_tail.load(std::memory_order::acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const noexcept {
+        return m_capacity;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq;
+        MaybeUninit<T> value;
+    };
+
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_capacity;
+    std::unique_ptr<Slot[]> m_slots;
+};
+
+template <typename T>
+struct Shared {
+    explicit Shared(size_t capacity) : m_queue(capacity) {}
+
+    bool isClosed() const noexcept {
+        return m_closed.load(std::memory_order::acquire);
+    }
+
+    bool hasCapacity() const noexcept {
+        return m_queue.size() < m_queue.capacity();
+    }
+
+    bool empty() const noexcept {
+        return m_queue.size() == 0;
+    }
+
+    void senderCloned() noexcept {
+        m_senders.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    void senderDropped() {
+        if (m_senders.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            this->close();
+        }
+    }
+
+    void receiverCloned() noexcept {
+        m_receivers.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    void receiverDropped() {
+        if (m_receivers.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            this->close();
+        }
+    }
+
+    TrySendOutcome trySend(T& value) {
+        if (this->isClosed()) {
+            return TrySendOutcome::Closed;
+        }
+
+        if (!m_queue.push(value)) {
+            return TrySendOutcome::Full;
+        }
+
+        this->notifyReceiver();
+        return TrySendOutcome::Success;
+    }
+
+    Result<T, TryRecvOutcome> tryRecv() {
+        if (auto value = m_queue.pop()) {
+            this->notifySender();
+            return Ok(std::move(*value));
+        }
+
+        if (this->isClosed()) {
+            // a sender might have pushed right before the channel got closed, check once more
+            if (auto value = m_queue.pop()) {
+                return Ok(std::move(*value));
+            }
+
+            return Err(TryRecvOutcome::Closed);
+        }
+
+        return Err(TryRecvOutcome::Empty);
+    }
+
+    TrySendOutcome trySendOrRegister(SendAwaiter<T>* awaiter, Context& cx) {
+        auto outcome = this->trySend(*awaiter->m_value);
+        if (outcome != TrySendOutcome::Full) {
+            return outcome;
+        }
+
+        auto waiters = m_sendWaiters.lock();
+        waiters->add(*cx.waker(), awaiter);
+        awaiter->m_state.store(WaitState::Waiting, std::memory_order::release);
+        m_sendWaiting.fetch_add(1, std::memory_order::relaxed);
+
+        // synchronizes with the fence in notifySender, either we see the freed slot or the receiver sees us
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+
+        outcome = this->isClosed() ? TrySendOutcome::Closed : TrySendOutcome::Full;
+        if (outcome == TrySendOutcome::Full && m_queue.push(*awaiter->m_value)) {
+            outcome = TrySendOutcome::Success;
+        }
+
+        if (outcome != TrySendOutcome::Full) {
+            waiters->remove(awaiter);
+            m_sendWaiting.fetch_sub(1, std::memory_order::relaxed);
+            awaiter->m_state.store(WaitState::Init, std::memory_order::release);
+            waiters.unlock();
+
+            if (outcome == TrySendOutcome::Success) {
+                this->notifyReceiver();
+            }
+        }
+
+        return outcome;
+    }
+
+    Result<T, TryRecvOutcome> tryRecvOrRegister(RecvAwaiter<T>* awaiter, Context& cx) {
+        auto res = this->tryRecv();
+        if (res || res.unwrapErr() == TryRecvOutcome::Closed) {
+            return res;
+        }
+
+        auto waiters = m_recvWaiters.lock();
+        waiters->add(*cx.waker(), awaiter);
+        awaiter->m_state.store(WaitState::Waiting, std::memory_order::release);
+        m_recvWaiting.fetch_add(1, std::memory_order::relaxed);
+
+        // synchronizes with the fence in notifyReceiver, either we see the new value or the sender sees us
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+
+        auto value = m_queue.pop();
+        if (!value && !this->isClosed()) {
+            return Err(TryRecvOutcome::Empty);
+        }
+
+        waiters->remove(awaiter);
+        m_recvWaiting.fetch_sub(1, std::memory_order::relaxed);
+        awaiter->m_state.store(WaitState::Init, std::memory_order::release);
+        waiters.unlock();
+
+        if (value) {
+            this->notifySender();
+            return Ok(std::move(*value));
+        }
+
+        return Err(TryRecvOutcome::Closed);
+    }
+
+    void deregisterSender(SendAwaiter<T>* awaiter) {
+        auto waiters = m_sendWaiters.lock();
+        auto state = awaiter->m_state.load(std::memory_order::acquire);
+
+        if (state == WaitState::Waiting) {
+            waiters->remove(awaiter);
+            m_sendWaiting.fetch_sub(1, std::memory_order::relaxed);
+        } else if (state == WaitState::Notified) {
+            // we were woken up but never got to use the free slot, pass the notification on
+            waiters.unlock();
+            this->notifySender();
+        }
+    }
+
+    void deregisterReceiver(RecvAwaiter<T>* awaiter) {
+        auto waiters = m_recvWaiters.lock();
+        auto state = awaiter->m_state.load(std::memory_order::acquire);
+
+        if (state == WaitState::Waiting) {
+            waiters->remove(awaiter);
+            m_recvWaiting.fetch_sub(1, std::memory_order::relaxed);
+        } else if (state == WaitState::Notified) {
+            // we were woken up but never took the value, pass the notification on
+            waiters.unlock();
+            this->notifyReceiver();
+        }
+    }
+
+    std::deque<T> drain() {
+        std::deque<T> out;
+        while (auto value = m_queue.pop()) {
+            out.push_back(std::move(*value));
+        }
+
+        // wake up all senders, since there's now plenty of free space
+        this->notifyAll(m_sendWaiters, m_sendWaiting);
+        return out;
+    }
+
+private:
+    RingBuffer<T> m_queue;
+    std::atomic<size_t> m_senders{0};
+    std::atomic<size_t> m_receivers{0};
+    std::atomic<bool> m_closed{false};
+
+    // waiter counts let the fast path skip locking the wait lists when nobody is waiting
+    std::atomic<size_t> m_sendWaiting{0};
+    std::atomic<size_t> m_recvWaiting{0};
+    asp::Mutex<WaitList<SendAwaiter<T>>> m_sendWaiters;
+    asp::Mutex<WaitList<RecvAwaiter<T>>> m_recvWaiters;
+
+    template <typename Awaiter>
+    static bool notifyOne(asp::Mutex<WaitList<Awaiter>>& list, std::atomic<size_t>& count) {
+        // pairs with the fence in trySendOrRegister / tryRecvOrRegister
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+
+        if (count.load(std::memory_order::relaxed) == 0) {
+            return false;
+        }
+
+        auto waiters = list.lock();
+        auto waiter = waiters->takeFirst();
+        if (!waiter) {
+            return false;
+        }
+
+        count.fetch_sub(1, std::memory_order::relaxed);
+        waiter->awaiter->m_state.store(WaitState::Notified, std::memory_order::release);
+        waiter->waker.wake();
+        return true;
+    }
+
+    template <typename Awaiter>
+    static void notifyAll(asp::Mutex<WaitList<Awaiter>>& list, std::atomic<size_t>& count) {
+        auto waiters = list.lock();
+        waiters->forAll([](Waker& waker, Awaiter* awaiter) {
+            awaiter->m_state.store(WaitState::Notified, std::memory_order::release);
+            waker.wake();
+        });
+        count.store(0, std::memory_order::relaxed);
+    }
+
+    void notifySender() {
+        notifyOne(m_sendWaiters, m_sendWaiting);
+    }
+
+    void notifyReceiver() {
+        notifyOne(m_recvWaiters, m_recvWaiting);
+    }
+
+    void close() {
+        m_closed.store(true, std::memory_order::release);
+        this->notifyAll(m_recvWaiters, m_recvWaiting);
+        this->notifyAll(m_sendWaiters, m_sendWaiting);
+    }
+};
+
+template <typename T>
+struct ARC_NODISCARD SendAwaiter : Pollable<SendAwaiter<T>, SendResult<T>>, WaitListNode {
+    explicit SendAwaiter(std::shared_ptr<Shared<T>> data, T value)
+        : m_data(std::move(data)), m_value(std::move(value)) {}
+
+    SendAwaiter(SendAwaiter&& other) noexcept
+        : m_data(std::move(other.m_data)),
+          m_value(std::move(other.m_value))
+    {
+        ARC_ASSERT(other.m_state.load(std::memory_order::relaxed) == WaitState::Init, "cannot move a SendAwaiter that already was polled");
+    }
+
+    SendAwaiter& operator=(SendAwaiter&& other) noexcept = delete;
+
+    ~SendAwaiter() {
+        if (m_data) m_data->deregisterSender(this);
+    }
+
+    std::optional<SendResult<T>> poll(Context& cx) {
+        // Init and Notified states both mean that we should try to push the value,
+        // Waiting means that we are registered and nobody woke us up yet.
+        switch (m_state.load(std::memory_order::acquire)) {
+            case WaitState::Waiting: return std::nullopt;
+            case WaitState::Done: return Ok();
+            default: break;
+        }
+
+        if (!cx.pollBudget()) {
+            return std::nullopt;
+        }
+
+        auto outcome = m_data->trySendOrRegister(this, cx);
+        switch (outcome) {
+            case TrySendOutcome::Success: {
+                m_state.store(WaitState::Done, std::memory_order::relaxed);
+                return Ok();
+            } break;
+
+            case TrySendOutcome::Closed: {
+                m_state.store(WaitState::Done, std::memory_order::relaxed);
+                return Err(std::move(*m_value));
+            } break;
+
+            case TrySendOutcome::Full: {
+                return std::nullopt; // waiting ..
+            } break;
+        }
+
+        std::unreachable();
+    }
+
+private:
+    friend struct Shared<T>;
+    std::shared_ptr<Shared<T>> m_data;
+    std::optional<T> m_value;
+    std::atomic<WaitState> m_state{WaitState::Init};
+};
+
+template <typename T>
+struct ARC_NODISCARD RecvAwaiter : Pollable<RecvAwaiter<T>, RecvResult<T>>, WaitListNode {
+    explicit RecvAwaiter(std::shared_ptr<Shared<T>> data) noexcept
+        : m_data(std::move(data)) {}
+
+    RecvAwaiter(RecvAwaiter&& other) noexcept : m_data(std::move(other.m_data)) {
+        ARC_ASSERT(other.m_state.load(std::memory_order::relaxed) == WaitState::Init, "cannot move a RecvAwaiter that already was polled");
+    }
+
+    RecvAwaiter& operator=(RecvAwaiter&& other) noexcept = delete;
+
+    ~RecvAwaiter() {
+        if (m_data) m_data->deregisterReceiver(this);
+    }
+
+    std::optional<RecvResult<T>> poll(Context& cx) {
+        // Init and Notified states both mean that we should try to take a value,
+        // Waiting means that we are registered and nobody woke us up yet.
+        // Polling again after completion is undefined behavior.
+        if (m_state.load(std::memory_order::acquire) == WaitState::Waiting || !cx.pollBudget()) {
+            return std::nullopt;
+        }
+
+        auto res = m_data->tryRecvOrRegister(this, cx);
+        if (res) {
+            m_state.store(WaitState::Done, std::memory_order::relaxed);
+            return Ok(std::move(res).unwrap());
+        }
+
+        switch (res.unwrapErr()) {
+            case TryRecvOutcome::Closed: {
+                m_state.store(WaitState::Done, std::memory_order::relaxed);
+                return Err(ClosedError{});
+            } break;
+
+            case TryRecvOutcome::Empty: {
+                return std::nullopt; // waiting ..
+            } break;
+
+            default: std::unreachable();
+        }
+    }
+
+private:
+    friend struct Shared<T>;
+    std::shared_ptr<Shared<T>> m_data;
+    std::atomic<WaitState> m_state{WaitState::Init};
+};
+
+template <typename T>
+struct Sender {
+    Sender(std::shared_ptr<Shared<T>> data) : m_data(std::move(data)) {
+        m_data->senderCloned();
+    }
+
+    ~Sender() {
+        if (m_data) m_data->senderDropped();
+    }
+
+    Sender(const Sender& other) : m_data(other.m_data) {
+        m_data->senderCloned();
+    }
+
+    Sender& operator=(const Sender& other) {
+        if (this != &other) {
+            if (m_data) m_data->senderDropped();
+            m_data = other.m_data;
+            m_data->senderCloned();
+        }
+        return *this;
+    }
+
+    Sender(Sender&& other) noexcept : m_data(std::exchange(other.m_data, nullptr)) {}
+
+    Sender& operator=(Sender&& other) noexcept {
+        if (this != &other) {
+            if (m_data) m_data->senderDropped();
+            m_data = std::exchange(other.m_data, nullptr);
+        }
+        return *this;
+    }
+
+    /// Attempts to send a value, waiting if there is no capacity left.
+    /// Returns the value back if the channel is closed.
+    SendAwaiter<T> send(T value) const {
+        return SendAwaiter<T>{m_data, std::move(value)};
+    }
+
+    /// Attempts to send a value without blocking, returns the value if the channel is full or closed.
+    SendResult<T> trySend(T value) const {
+        auto outcome = m_data->trySend(value);
+        if (outcome == TrySendOutcome::Success) {
+            return Ok();
+        }
+
+        return Err(std::move(value));
+    }
+
+    /// Checks if the channel has any capacity to accept new messages.
+    /// Note that this is only a hint, if this returns `true` there is no
+    /// guarantee that a subsequent `send()` will succeed without blocking.
+    bool hasCapacity() const noexcept {
+        return m_data->hasCapacity();
+    }
+
+private:
+    std::shared_ptr<Shared<T>> m_data;
+};
+
+template <typename T>
+struct Receiver {
+    Receiver(std::shared_ptr<Shared<T>> data) : m_data(std::move(data)) {
+        m_data->receiverCloned();
+    }
+
+    ~Receiver() {
+        if (m_data) m_data->receiverDropped();
+    }
+
+    Receiver(const Receiver& other) : m_data(other.m_data) {
+        m_data->receiverCloned();
+    }
+
+    Receiver& operator=(const Receiver& other) {
+        if (this != &other) {
+            if (m_data) m_data->receiverDropped();
+            m_data = other.m_data;
+            m_data->receiverCloned();
+        }
+        return *this;
+    }
+
+    Receiver(Receiver&& other) noexcept : m_data(std::exchange(other.m_data, nullptr)) {}
+
+    Receiver& operator=(Receiver&& other) noexcept {
+        if (this != &other) {
+            if (m_data) m_data->receiverDropped();
+            m_data = std::exchange(other.m_data, nullptr);
+        }
+        return *this;
+    }
+
+    /// Waits for a value. If multiple receivers are waiting, they are woken up in FIFO order.
+    RecvAwaiter<T> recv() noexcept {
+        return RecvAwaiter<T>{m_data};
+    }
+
+    Result<T, TryRecvOutcome> tryRecv() {
+        return m_data->tryRecv();
+    }
+
+    std::deque<T> drain() {
+        return m_data->drain();
+    }
+
+    bool empty() const noexcept {
+        return m_data->empty();
+    }
+
+private:
+    std::shared_ptr<Shared<T>> m_data;
+};
+
+/// Creates a new multi-producer, multi-consumer channel with the given capacity.
+/// Both Sender<T> and Receiver<T> may be copied, every value is delivered to exactly one receiver,
+/// which makes this channel suitable for distributing work between a pool of worker tasks.
+/// Waiting receivers (and senders) are woken up in FIFO order. The queue itself is lock-free,
+/// the wait lists are only locked when a sender or receiver actually has to wait.
+/// The channel is closed once either all senders or all receivers are destroyed.
+///
+/// Unlike mpsc, the channel is always bounded and capacity must be at least 1.
+/// This function does not require a runtime, and can be run in both synchronous and asynchronous contexts.
+template <typename T>
+std::pair<Sender<T>, Receiver<T>> channel(size_t capacity) {
+    ARC_ASSERT(capacity > 0, "mpmc channel capacity must be nonzero");
+
+    auto shared = std::make_shared<Shared<T>>(capacity);
+    return std::make_pair(Sender<T>{shared}, Receiver<T>{shared});
+}
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <arc/future/Pollable.hpp>
 #include <arc/task/Waker.hpp>
+#include <arc/task/AtomicWaker.hpp>
 #include <arc/util/Trace.hpp>
 #include <asp/sync/SpinLock.hpp>
 #include "ChannelBase.hpp"
@@ -134,10 +135,8 @@ struct Shared {
         }
 
         // register the awaiter
-        if (!awaiter->m_waker) {
-            awaiter->m_waker = cx.cloneWaker();
-        }
-
+        awaiter->m_waker.registerWaker(cx);
+        awaiter->m_state.store(RecvState::Waiting, std::memory_order::release);
         data->registerRecvWaiter(awaiter);
         return Err(TryRecvOutcome::Empty);
     }
@@ -200,6 +199,10 @@ struct ARC_NODISCARD SendAwaiter : Pollable<SendAwaiter<T>, SendResult<T>> {
 
         if (m_value && !m_waker) {
             // handle initial state
+            if (!cx.pollBudget()) {
+                return std::nullopt;
+            }
+
             auto outcome = m_data->trySendOrRegister(this, cx);
             switch (outcome) {
                 case TrySendOutcome::Success: {
@@ -320,11 +323,9 @@ struct ARC_NODISCARD RecvAwaiter : Pollable<RecvAwaiter<T>, RecvResult<T>, Chann
         : m_data(std::move(data)) {}
 
     RecvAwaiter(RecvAwaiter&& other) noexcept
-        : m_data(std::move(other.m_data)),
-            m_value(std::move(other.m_value)),
-            m_waker(std::move(other.m_waker))
+        : m_data(std::move(other.m_data))
     {
-        ARC_ASSERT(!m_waker && !m_value, "cannot move a RecvAwaiter that already was polled");
+        ARC_ASSERT(other.m_state.load(std::memory_order::relaxed) == RecvState::Init, "cannot move a RecvAwaiter that already was polled");
     }
 
     RecvAwaiter& operator=(RecvAwaiter&& other) noexcept = delete;
@@ -344,46 +345,59 @@ struct ARC_NODISCARD RecvAwaiter : Pollable<RecvAwaiter<T>, RecvResult<T>, Chann
     }
 
     std::optional<RecvResult<T>> poll(Context& cx) noexcept(ChannelData<T>::NoexceptMovable) {
-        // We have two valid states for being polled, and the 3rd completed state:
-        // 1. Initial state, m_value is not set, m_waker is not set
-        // 2. Waiting state, m_value is not set, m_waker is set
-        // 3. Done state, m_value is set, m_waker is anything
-        // Polling again after the done state is undefined behavior.
-        auto guard = m_lock.lock();
-
-        if (!m_value && !m_waker) {
-            // handle initial state
-            auto res = m_data->tryRecvOrRegister(this, cx);
-            if (res) {
-                // immediately received, complete the future
-                return Ok(std::move(res).unwrap());
-            }
-
-            auto outcome = res.unwrapErr();
-            switch (outcome) {
-                case TryRecvOutcome::Closed: {
+        // 1. Initial state, not registered in the channel
+        // 2. Waiting state, registered in the channel and waiting for a sender to deliver a value
+        // 3. Delivered state, m_value is set by the sender
+        // Polling again after the value was taken is undefined behavior.
+        switch (m_state.load(std::memory_order::acquire)) {
+            case RecvState::Init: {
+                if (!cx.pollBudget()) {
+                    return std::nullopt;
+                }
+
+                auto res = m_data->tryRecvOrRegister(this, cx);
+                if (res) {
+                    // immediately received, complete the future
+                    return Ok(std::move(res).unwrap());
+                }
+
+                auto outcome = res.unwrapErr();
+                switch (outcome) {
+                    case TryRecvOutcome::Closed: {
+                        return Err(ClosedError{});
+                    } break;
+
+                    case TryRecvOutcome::Empty: {
+                        return std::nullopt; // waiting ..
+                    } break;
+
+                    default: std::unreachable();
+                }
+            } break;
+
+            case RecvState::Waiting: {
+                // refresh the waker in case we got moved to another task, then check again.
+                // closure must be loaded before the state, a sender always delivers before closing.
+                m_waker.registerWaker(cx);
+                bool closed = m_data->isClosed();
+
+                if (m_state.load(std::memory_order::acquire) == RecvState::Delivered) {
+                    return this->takeValue();
+                }
+
+                if (closed) {
                     return Err(ClosedError{});
-                } break;
+                }
 
-                case TryRecvOutcome::Empty: {
-                    return std::nullopt; // waiting ..
-                } break;
-
-                default: std::unreachable();
-            }
-        } else if (!m_value && m_waker) {
-            // handle waiting state, once again, nothing to do here besides check for closure
-            if (m_data->isClosed()) {
-                return Err(ClosedError{});
-            }
+                return std::nullopt;
+            } break;
 
-            return std::nullopt;
-        } else {
-            // completed!
-            auto val = std::move(*m_value);
-            m_value.reset();
-            return Ok(std::move(val));
+            case RecvState::Delivered: {
+                return this->takeValue();
+            } break;
         }
+
+        std::unreachable();
     }
 
 private:
@@ -391,18 +405,25 @@ private:
     friend struct MpscStorage<T, SendAwaiter<T>, RecvAwaiter<T>>;
     friend struct Shared<T>;
     std::shared_ptr<Shared<T>> m_data;
-    Waker m_waker;
+    AtomicWaker m_waker;
     std::optional<T> m_value;
-    asp::SpinLock<> m_lock;
+    std::atomic<RecvState> m_state{RecvState::Init};
 
-    /// Attempts to externally insert the value into this receiver, only works if in the waiting state
+    RecvResult<T> takeValue() noexcept(ChannelData<T>::NoexceptMovable) {
+        auto val = std::move(*m_value);
+        m_value.reset();
+        return Ok(std::move(val));
+    }
+
+    /// Attempts to externally insert the value into this receiver, only works if in the waiting state.
+    /// Must be called with the channel locked.
     bool tryDeliver(T& value) {
-        auto guard = m_lock.lock();
-        if (!m_waker || m_value) {
+        if (m_state.load(std::memory_order::acquire) != RecvState::Waiting) {
             return false;
         }
 
         m_value = std::move(value);
+        m_state.store(RecvState::Delivered, std::memory_order::release);
         m_waker.wake();
         return true;
     }
@@ -1,109 +1,168 @@
 #pragma once
 #include <arc/future/Pollable.hpp>
 #include <arc/task/Waker.hpp>
+#include <arc/task/AtomicWaker.hpp>
+#include <arc/util/MaybeUninit.hpp>
 #include <arc/util/Trace.hpp>
-#include <asp/sync/SpinLock.hpp>
 #include "ChannelBase.hpp"
 #include <atomic>
-#include <memory>
 
 namespace arc::oneshot {
 
 using namespace arc::chan;
 
+/// The single heap cell shared by both halves of a oneshot channel.
+/// It is intrusively refcounted and synchronized entirely with atomics, there are no locks involved.
 template <typename T>
-struct SendAwaiter;
-template <typename T>
-struct RecvAwaiter;
-template <typename T>
-using Storage = OneshotStorage<T, RecvAwaiter<T>>;
+struct Shared {
+    static constexpr bool NoexceptMovable = std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>;
 
-template <typename T>
-struct ChannelData : Storage<T> {
-    using Storage<T>::Storage;
+    static constexpr uint8_t VALUE_SENT = 1 << 0;
+    static constexpr uint8_t VALUE_TAKEN = 1 << 1;
+    static constexpr uint8_t CLOSED = 1 << 2;
+
+    Shared() noexcept = default;
+    Shared(const Shared&) = delete;
+    Shared& operator=(const Shared&) = delete;
 
-    void wakeWaiter() {
-        if (this->recvWaiter) {
-            this->recvWaiter->m_waker.wake();
-            this->recvWaiter = nullptr;
+    ~Shared() {
+        uint8_t state = m_state.load(std::memory_order::acquire);
+        if ((state & VALUE_SENT) && !(state & VALUE_TAKEN)) {
+            m_value.drop();
         }
     }
-};
 
-template <typename T>
-struct Shared {
-    explicit Shared() {}
+    void retain() noexcept {
+        m_refs.fetch_add(1, std::memory_order::relaxed);
+    }
 
-    void receiverDropped() {
-        this->close();
+    void release() noexcept {
+        if (m_refs.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    void receiverDropped() noexcept {
+        m_state.fetch_or(CLOSED, std::memory_order::acq_rel);
     }
 
-    void senderDropped() {
-        this->close();
+    void senderDropped() noexcept {
+        uint8_t prev = m_state.fetch_or(CLOSED, std::memory_order::acq_rel);
+        if (!(prev & VALUE_SENT)) {
+            m_rxWaker.wake();
+        }
     }
 
-    TrySendOutcome send(T& value) const noexcept(Storage<T>::NoexceptMovable) {
+    TrySendOutcome send(T& value) noexcept(NoexceptMovable) {
         if (this->isClosed()) {
             return TrySendOutcome::Closed;
         }
 
-        m_data.lock()->push(value);
-        return TrySendOutcome::Success;
-    }
+        ARC_DEBUG_ASSERT(!(m_state.load(std::memory_order::relaxed) & VALUE_SENT), "Sending to a oneshot channel that already has a value!");
+        m_value.init(std::move(value));
 
-    Result<T, TryRecvOutcome> tryRecv() const noexcept(Storage<T>::NoexceptMovable) {
-        auto value = m_data.lock()->pop();
+        uint8_t prev = m_state.fetch_or(VALUE_SENT, std::memory_order::acq_rel);
+        if (prev & CLOSED) {
+            // the receiver was dropped in the meantime, try to take the value back.
+            // if this fails, the value was received after all
+            if (auto taken = this->claimValue()) {
+                value = std::move(*taken);
+                return TrySendOutcome::Closed;
+            }
 
-        if (value) {
-            return Ok(std::move(*value));
+            return TrySendOutcome::Success;
         }
 
-        return Err(this->isClosed() ? TryRecvOutcome::Closed : TryRecvOutcome::Empty);
+        m_rxWaker.wake();
+        return TrySendOutcome::Success;
     }
 
-    Result<T, TryRecvOutcome> tryRecvOrRegister(RecvAwaiter<T>* awaiter, Context& cx) const noexcept(Storage<T>::NoexceptMovable) {
-        auto data = m_data.lock();
-        auto value = data->pop();
-
-        if (value) {
+    Result<T, TryRecvOutcome> tryRecv() noexcept(NoexceptMovable) {
+        if (auto value = this->claimValue()) {
             return Ok(std::move(*value));
         }
 
-        if (this->isClosed()) {
-            return Err(TryRecvOutcome::Closed);
-        }
+        uint8_t state = m_state.load(std::memory_order::acquire);
+        return Err((state & CLOSED) ? TryRecvOutcome::Closed : TryRecvOutcome::Empty);
+    }
 
-        // register the awaiter
-        if (!awaiter->m_waker) {
-            awaiter->m_waker = cx.cloneWaker();
+    Result<T, TryRecvOutcome> tryRecvOrRegister(Context& cx) noexcept(NoexceptMovable) {
+        auto res = this->tryRecv();
+        if (res || res.unwrapErr() == TryRecvOutcome::Closed) {
+            return res;
         }
 
-        data->registerRecvWaiter(awaiter);
-        return Err(TryRecvOutcome::Empty);
-    }
-
-    void deregisterReceiver(RecvAwaiter<T>* awaiter) const {
-        m_data.lock()->recvWaiter = nullptr;
+        // register and check again, in case the value was sent in between
+        m_rxWaker.registerWaker(cx);
+        return this->tryRecv();
     }
 
     bool isClosed() const noexcept {
-        return m_closed.load(std::memory_order::acquire);
+        return m_state.load(std::memory_order::acquire) & CLOSED;
     }
 
 private:
-    asp::SpinLock<ChannelData<T>> m_data;
-    std::atomic<bool> m_closed{false};
+    std::atomic<uint32_t> m_refs{2};
+    std::atomic<uint8_t> m_state{0};
+    AtomicWaker m_rxWaker;
+    MaybeUninit<T> m_value;
+
+    /// Takes the value out if it was sent and nobody has taken it yet
+    std::optional<T> claimValue() noexcept(NoexceptMovable) {
+        uint8_t state = m_state.load(std::memory_order::acquire);
+
+        while ((state & VALUE_SENT) && !(state & VALUE_TAKEN)) {
+            if (m_state.compare_exchange_weak(state, state | VALUE_TAKEN, std::memory_order::acq_rel, std::memory_order::acquire)) {
+                std::optional<T> out{std::move(m_value.assumeInit())};
+                m_value.drop();
+                return out;
+            }
+        }
 
-    void close() {
-        m_closed.store(true, std::memory_order::release);
-        m_data.lock()->wakeWaiter();
+        return std::nullopt;
     }
 };
 
+/// Owning reference to the shared cell, used by both halves and the receive awaiter
+template <typename T>
+struct SharedRef {
+    SharedRef(Shared<T>* ptr) noexcept : m_ptr(ptr) {}
+
+    SharedRef(const SharedRef& other) noexcept : m_ptr(other.m_ptr) {
+        if (m_ptr) m_ptr->retain();
+    }
+
+    SharedRef& operator=(const SharedRef&) = delete;
+
+    SharedRef(SharedRef&& other) noexcept : m_ptr(std::exchange(other.m_ptr, nullptr)) {}
+
+    SharedRef& operator=(SharedRef&& other) noexcept {
+        if (this != &other) {
+            if (m_ptr) m_ptr->release();
+            m_ptr = std::exchange(other.m_ptr, nullptr);
+        }
+        return *this;
+    }
+
+    ~SharedRef() {
+        if (m_ptr) m_ptr->release();
+    }
+
+    Shared<T>* operator->() const noexcept {
+        return m_ptr;
+    }
+
+    explicit operator bool() const noexcept {
+        return m_ptr != nullptr;
+    }
+
+private:
+    Shared<T>* m_ptr;
+};
 
 template <typename T>
 struct Sender {
-    Sender(std::shared_ptr<Shared<T>> data) : m_data(std::move(data)) {}
+    Sender(SharedRef<T> data) noexcept : m_data(std::move(data)) {}
 
     ~Sender() {
         if (m_data) m_data->senderDropped();
@@ -116,14 +175,14 @@ struct Sender {
     Sender& operator=(Sender&& other) noexcept {
         if (this != &other) {
             if (m_data) m_data->senderDropped();
-            m_data = std::exchange(other.m_data, nullptr);
+            m_data = std::move(other.m_data);
         }
         return *this;
     }
 
     /// Sends a value over the channel. This never blocks and will send the value immediately.
     /// It is undefined behavior to call this more than once. The only possible failure case is if the channel is closed by receiver.
-    SendResult<T> send(T value) const noexcept(Storage<T>::NoexceptMovable) {
+    SendResult<T> send(T value) const noexcept(Shared<T>::NoexceptMovable) {
         auto outcome = m_data->send(value);
         if (outcome == TrySendOutcome::Success) {
             return Ok();
@@ -132,98 +191,54 @@ struct Sender {
         return Err(std::move(value));
     }
 
+    /// Returns whether the receiver has been dropped, in which case sending will fail.
+    bool isClosed() const noexcept {
+        return m_data->isClosed();
+    }
+
 private:
-    std::shared_ptr<Shared<T>> m_data;
+    SharedRef<T> m_data;
 };
 
 template <typename T>
-struct ARC_NODISCARD RecvAwaiter : Pollable<RecvAwaiter<T>, RecvResult<T>, Storage<T>::NoexceptMovable> {
-    explicit RecvAwaiter(std::shared_ptr<Shared<T>> data) noexcept
+struct ARC_NODISCARD RecvAwaiter : Pollable<RecvAwaiter<T>, RecvResult<T>, Shared<T>::NoexceptMovable> {
+    explicit RecvAwaiter(SharedRef<T> data) noexcept
         : m_data(std::move(data)) {}
 
-    RecvAwaiter(RecvAwaiter&& other) noexcept
-        : m_data(std::move(other.m_data)),
-            m_value(std::move(other.m_value)),
-            m_waker(std::move(other.m_waker))
-    {
-        ARC_ASSERT(!m_waker && !m_value, "cannot move a RecvAwaiter that already was polled");
-    }
-
+    RecvAwaiter(RecvAwaiter&& other) noexcept = default;
     RecvAwaiter& operator=(RecvAwaiter&& other) noexcept = delete;
 
-    ~RecvAwaiter() {
-        // if we are in the waiting state, remove ourselves from the wait list
-        if (m_data) m_data->deregisterReceiver(this);
-    }
-
-    std::optional<RecvResult<T>> poll(Context& cx) noexcept(Storage<T>::NoexceptMovable) {
-        // We have two valid states for being polled, and the 3rd completed state:
-        // 1. Initial state, m_value is not set, m_waker is not set
-        // 2. Waiting state, m_value is not set, m_waker is set
-        // 3. Done state, m_value is set, m_waker is anything
-        // Polling again after the done state is undefined behavior.
-        auto guard = m_lock.lock();
-
-        if (!m_value && !m_waker) {
-            // handle initial state
-            auto res = m_data->tryRecvOrRegister(this, cx);
-            if (res) {
-                // immediately received, complete the future
-                return Ok(std::move(res).unwrap());
-            }
-
-            auto outcome = res.unwrapErr();
-            switch (outcome) {
-                case TryRecvOutcome::Closed: {
-                    return Err(ClosedError{});
-                } break;
+    std::optional<RecvResult<T>> poll(Context& cx) noexcept(Shared<T>::NoexceptMovable) {
+        // Polling again after the value was received is undefined behavior.
+        if (!cx.pollBudget()) {
+            return std::nullopt;
+        }
 
-                case TryRecvOutcome::Empty: {
-                    return std::nullopt; // waiting ..
-                } break;
+        auto res = m_data->tryRecvOrRegister(cx);
+        if (res) {
+            return Ok(std::move(res).unwrap());
+        }
 
-                default: std::unreachable();
-            }
-        } else if (!m_value && m_waker) {
-            // handle waiting state, once again, nothing to do here besides check for closure
-            if (m_data->isClosed()) {
+        switch (res.unwrapErr()) {
+            case TryRecvOutcome::Closed: {
                 return Err(ClosedError{});
-            }
+            } break;
 
-            return std::nullopt;
-        } else {
-            // completed!
-            auto val = std::move(*m_value);
-            m_value.reset();
-            return Ok(std::move(val));
+            case TryRecvOutcome::Empty: {
+                return std::nullopt; // waiting ..
+            } break;
+
+            default: std::unreachable();
         }
     }
 
 private:
-    friend struct ChannelData<T>;
-    friend struct OneshotStorage<T, RecvAwaiter<T>>;
-    friend struct Shared<T>;
-    std::shared_ptr<Shared<T>> m_data;
-    Waker m_waker;
-    std::optional<T> m_value;
-    asp::SpinLock<> m_lock;
-
-    /// Attempts to externally insert the value into this receiver, only works if in the waiting state
-    bool tryDeliver(T& value) noexcept(Storage<T>::NoexceptMovable) {
-        auto guard = m_lock.lock();
-        if (!m_waker || m_value) {
-            return false;
-        }
-
-        m_value = std::move(value);
-        m_waker.wake();
-        return true;
-    }
+    SharedRef<T> m_data;
 };
 
 template <typename T>
 struct Receiver {
-    Receiver(std::shared_ptr<Shared<T>> data) : m_data(std::move(data)) {}
+    Receiver(SharedRef<T> data) noexcept : m_data(std::move(data)) {}
     Receiver(const Receiver&) = delete;
     Receiver& operator=(const Receiver&) = delete;
     Receiver(Receiver&&) noexcept = default;
@@ -244,16 +259,17 @@ struct Receiver {
         return RecvAwaiter<T>{m_data};
     }
 
-    Result<T, TryRecvOutcome> tryRecv() noexcept(Storage<T>::NoexceptMovable) {
+    Result<T, TryRecvOutcome> tryRecv() noexcept(Shared<T>::NoexceptMovable) {
         return m_data->tryRecv();
     }
 
 private:
-    std::shared_ptr<Shared<T>> m_data;
+    SharedRef<T> m_data;
 };
 
 /// Creates a new oneshot channel, returning the sender and receiver halves.
 /// Sender and Receiver cannot be copied, and only a single message can ever be sent through the channel.
+/// Both halves share a single small heap allocation, and no locks are used.
 ///
 /// `send()` never blocks, and either inserts the message into the channel or straight into the receiver.
 /// Calling `send()` more than once is UB, as is calling `recv()`/`tryRecv()` after a message has been received.
@@ -261,8 +277,8 @@ private:
 /// This function does not require a runtime, and can be run in both synchronous and asynchronous contexts.
 template <typename T>
 std::pair<Sender<T>, Receiver<T>> channel() {
-    auto shared = std::make_shared<Shared<T>>();
-    return std::make_pair(Sender<T>{shared}, Receiver<T>{shared});
+    auto shared = new Shared<T>();
+    return std::make_pair(Sender<T>{SharedRef<T>{shared}}, Receiver<T>{SharedRef<T>{shared}});
 }
 
 }
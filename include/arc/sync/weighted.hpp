@@ -0,0 +1,287 @@
+#pragma once
+#include <arc/util/Function.hpp>
+#include "mpsc.hpp"
+#include "Semaphore.hpp"
+#include <limits>
+
+namespace arc::weighted {
+
+using namespace arc::chan;
+
+template <typename T>
+struct SendAwaiter;
+template <typename T>
+struct RecvAwaiter;
+template <typename T>
+struct Sender;
+template <typename T>
+struct Receiver;
+
+template <typename T>
+using WeightFn = MoveOnlyFunction<size_t(const T&)>;
+
+template <typename T>
+struct Item {
+    T value;
+    size_t weight;
+};
+
+template <typename T>
+struct Shared {
+    explicit Shared(size_t budget, WeightFn<T> weightFn)
+        : m_budget(budget), m_sem(budget), m_weightFn(std::move(weightFn)) {}
+
+    bool isClosed() const noexcept {
+        return m_closed.load(std::memory_order::acquire);
+    }
+
+    /// Returns the weight of the value, clamped to the total budget so that oversized values can still be sent
+    size_t weightOf(const T& value) {
+        return std::min(m_weightFn(value), m_budget);
+    }
+
+    void receiverDropped() {
+        m_closed.store(true, std::memory_order::release);
+
+        // release a practically infinite amount of permits, so that every waiting sender wakes up and notices the closure
+        m_sem.release(std::numeric_limits<size_t>::max() / 2);
+    }
+
+private:
+    friend struct SendAwaiter<T>;
+    friend struct RecvAwaiter<T>;
+    friend struct Sender<T>;
+    friend struct Receiver<T>;
+
+    size_t m_budget;
+    Semaphore m_sem;
+    WeightFn<T> m_weightFn;
+    std::atomic<bool> m_closed{false};
+};
+
+template <typename T>
+struct ARC_NODISCARD SendAwaiter : Pollable<SendAwaiter<T>, SendResult<T>> {
+    explicit SendAwaiter(std::shared_ptr<Shared<T>> data, mpsc::Sender<Item<T>> tx, T value)
+        : m_data(std::move(data)), m_tx(std::move(tx)), m_value(std::move(value)) {}
+
+    SendAwaiter(SendAwaiter&& other) noexcept
+        : m_data(std::move(other.m_data)),
+          m_tx(std::move(other.m_tx)),
+          m_value(std::move(other.m_value)),
+          m_weight(other.m_weight)
+    {
+        ARC_ASSERT(!other.m_acquire, "cannot move a SendAwaiter that already was polled");
+    }
+
+    SendAwaiter& operator=(SendAwaiter&& other) noexcept = delete;
+
+    std::optional<SendResult<T>> poll(Context& cx) {
+        // 1. Initial state, m_weight is not set
+        // 2. Waiting state, m_acquire is set and waits for the budget
+        // 3. Done state, m_value is not set
+        if (!m_value) {
+            return Ok();
+        }
+
+        if (!m_weight) {
+            if (!cx.pollBudget()) {
+                return std::nullopt;
+            }
+
+            if (m_data->isClosed()) {
+                return this->complete();
+            }
+
+            m_weight = m_data->weightOf(*m_value);
+
+            // fast path, if there's enough budget, don't bother with creating the awaiter
+            if (!m_data->m_sem.tryAcquire(*m_weight)) {
+                m_acquire.emplace(m_data->m_sem.acquire(*m_weight));
+            }
+        }
+
+        if (m_acquire) {
+            if (!m_acquire->poll(cx)) {
+                return std::nullopt;
+            }
+
+            m_acquire.reset();
+        }
+
+        return this->complete();
+    }
+
+private:
+    std::shared_ptr<Shared<T>> m_data;
+    mpsc::Sender<Item<T>> m_tx;
+    std::optional<T> m_value;
+    std::optional<size_t> m_weight;
+    std::optional<Semaphore::AcquireAwaiter> m_acquire;
+
+    /// Pushes the value into the channel, the budget must already be acquired at this point.
+    SendResult<T> complete() {
+        T value = std::move(*m_value);
+        m_value.reset();
+
+        if (!m_weight || m_data->isClosed()) {
+            if (m_weight) m_data->m_sem.release(*m_weight);
+            return Err(std::move(value));
+        }
+
+        // the inner channel is unbounded, so this only fails if it's closed
+        auto res = m_tx.trySend(Item<T>{std::move(value), *m_weight});
+        if (res) {
+            return Ok();
+        }
+
+        m_data->m_sem.release(*m_weight);
+        return Err(std::move(std::move(res).unwrapErr().value));
+    }
+};
+
+template <typename T>
+struct ARC_NODISCARD RecvAwaiter : Pollable<RecvAwaiter<T>, RecvResult<T>> {
+    explicit RecvAwaiter(std::shared_ptr<Shared<T>> data, mpsc::RecvAwaiter<Item<T>> inner)
+        : m_data(std::move(data)), m_inner(std::move(inner)) {}
+
+    std::optional<RecvResult<T>> poll(Context& cx) {
+        auto res = m_inner.poll(cx);
+        if (!res) {
+            return std::nullopt;
+        }
+
+        if (!*res) {
+            return Err(ClosedError{});
+        }
+
+        auto item = std::move(*res).unwrap();
+        m_data->m_sem.release(item.weight);
+        return Ok(std::move(item.value));
+    }
+
+private:
+    std::shared_ptr<Shared<T>> m_data;
+    mpsc::RecvAwaiter<Item<T>> m_inner;
+};
+
+template <typename T>
+struct Sender {
+    Sender(std::shared_ptr<Shared<T>> data, mpsc::Sender<Item<T>> tx)
+        : m_data(std::move(data)), m_tx(std::move(tx)) {}
+
+    /// Attempts to send a value, waiting until there is enough budget for its weight.
+    /// Values heavier than the entire budget are treated as if they weigh exactly the budget.
+    /// Returns the value back if the channel is closed.
+    SendAwaiter<T> send(T value) const {
+        return SendAwaiter<T>{m_data, m_tx, std::move(value)};
+    }
+
+    /// Attempts to send a value without blocking, returns the value if there's not enough budget or the channel is closed.
+    SendResult<T> trySend(T value) const {
+        if (m_data->isClosed()) {
+            return Err(std::move(value));
+        }
+
+        size_t weight = m_data->weightOf(value);
+        if (!m_data->m_sem.tryAcquire(weight)) {
+            return Err(std::move(value));
+        }
+
+        auto res = m_tx.trySend(Item<T>{std::move(value), weight});
+        if (res) {
+            return Ok();
+        }
+
+        m_data->m_sem.release(weight);
+        return Err(std::move(std::move(res).unwrapErr().value));
+    }
+
+    /// Returns the amount of budget that is currently not taken up by queued values.
+    /// Note that this is only a hint, just like `mpsc::Sender::hasCapacity()`.
+    size_t availableBudget() const noexcept {
+        return m_data->isClosed() ? 0 : m_data->m_sem.permits();
+    }
+
+private:
+    std::shared_ptr<Shared<T>> m_data;
+    mpsc::Sender<Item<T>> m_tx;
+};
+
+template <typename T>
+struct Receiver {
+    Receiver(std::shared_ptr<Shared<T>> data, mpsc::Receiver<Item<T>> rx)
+        : m_data(std::move(data)), m_rx(std::move(rx)) {}
+
+    Receiver(const Receiver&) = delete;
+    Receiver& operator=(const Receiver&) = delete;
+    Receiver(Receiver&&) noexcept = default;
+    Receiver& operator=(Receiver&&) noexcept = delete;
+
+    ~Receiver() {
+        if (!m_data) return;
+
+        // close the inner channel first, so that woken up senders fail to push their values
+        {
+            auto rx = std::move(m_rx);
+        }
+
+        m_data->receiverDropped();
+    }
+
+    RecvAwaiter<T> recv() noexcept {
+        return RecvAwaiter<T>{m_data, m_rx.recv()};
+    }
+
+    Result<T, TryRecvOutcome> tryRecv() {
+        auto res = m_rx.tryRecv();
+        if (!res) {
+            return Err(res.unwrapErr());
+        }
+
+        auto item = std::move(res).unwrap();
+        m_data->m_sem.release(item.weight);
+        return Ok(std::move(item.value));
+    }
+
+    std::deque<T> drain() {
+        std::deque<T> out;
+        size_t weight = 0;
+
+        for (auto& item : m_rx.drain()) {
+            weight += item.weight;
+            out.push_back(std::move(item.value));
+        }
+
+        m_data->m_sem.release(weight);
+        return out;
+    }
+
+    bool empty() const noexcept {
+        return m_rx.empty();
+    }
+
+private:
+    std::shared_ptr<Shared<T>> m_data;
+    mpsc::Receiver<Item<T>> m_rx;
+};
+
+/// Creates a new multi-producer, single-consumer channel whose capacity is a budget of weight units
+/// rather than an amount of values. Every value is weighed with `weightFn` when it's sent,
+/// and senders wait until enough budget is free (waiting senders are served in FIFO order).
+/// The weight is returned to the budget once the receiver takes the value out of the channel.
+/// This is useful to put a ceiling on memory use, e.g. by using the size of a buffer in bytes as its weight.
+///
+/// Values weighing more than the entire budget are clamped to the budget, so they can still be sent,
+/// but only when the channel is otherwise empty.
+/// This function does not require a runtime, and can be run in both synchronous and asynchronous contexts.
+template <typename T>
+std::pair<Sender<T>, Receiver<T>> channel(size_t budget, WeightFn<T> weightFn) {
+    ARC_ASSERT(budget > 0, "weighted channel budget must be nonzero");
+
+    auto shared = std::make_shared<Shared<T>>(budget, std::move(weightFn));
+    auto [tx, rx] = mpsc::channel<Item<T>>(std::nullopt);
+
+    return std::make_pair(Sender<T>{shared, std::move(tx)}, Receiver<T>{shared, std::move(rx)});
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Waker.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace arc {
+
+struct Context;
+
+/// A synchronization primitive for handing off a single waker between one task that waits and one notifier,
+/// without using any locks. This is the same state machine as `AtomicWaker` from futures-rs.
+///
+/// The waiting side calls `registerWaker()` every time it's polled and then re-checks its readiness condition,
+/// the notifying side sets the condition and then calls `wake()`. Concurrent calls to `registerWaker()` are not allowed,
+/// while `wake()` and `take()` may be called concurrently from any amount of threads.
+struct AtomicWaker {
+    AtomicWaker() noexcept = default;
+    AtomicWaker(const AtomicWaker&) = delete;
+    AtomicWaker& operator=(const AtomicWaker&) = delete;
+    AtomicWaker(AtomicWaker&&) = delete;
+    AtomicWaker& operator=(AtomicWaker&&) = delete;
+
+    /// Registers the waker to be woken up by the next `wake()` call. Reuses the stored waker if it's equal.
+    /// If a `wake()` is in progress, the given waker is woken up immediately.
+    void registerWaker(const Waker& waker) noexcept;
+
+    /// Registers the waker of the given context, does nothing if the context has no waker.
+    void registerWaker(Context& cx) noexcept;
+
+    /// Wakes the registered waker, if any, and clears it.
+    void wake() noexcept;
+
+    /// Takes the registered waker out without waking it. Returns an empty waker if none is registered,
+    /// or if a registration or another wake is currently in progress.
+    Waker take() noexcept;
+
+private:
+    static constexpr uint8_t WAITING = 0;
+    static constexpr uint8_t REGISTERING = 1 << 0;
+    static constexpr uint8_t WAKING = 1 << 1;
+
+    std::atomic<uint8_t> m_state{WAITING};
+    Waker m_waker;
+};
+
+}
@@ -1,10 +1,10 @@
 #pragma once
 #include <arc/future/Future.hpp>
 #include <arc/task/Waker.hpp>
+#include <arc/task/AtomicWaker.hpp>
 #include <arc/task/CondvarWaker.hpp>
 #include <arc/util/Function.hpp>
 
-#include <asp/sync/SpinLock.hpp>
 #include <asp/ptr/SharedPtr.hpp>
 
 namespace arc {
@@ -38,41 +38,38 @@ struct BlockingTask : BlockingTaskBase {
         : BlockingTaskBase(std::move(runtime), &vtable), m_func(std::move(func)) {}
 
     std::optional<T> pollTask(Context& cx) noexcept {
-        auto data = m_data.lock();
-
-        if (data->m_result) {
-            auto out = std::move(*data->m_result);
-            data->m_result.reset();
+        if (auto out = this->takeResult()) {
             return out;
-        } else {
-            auto myWaker = cx.waker();
-            if (myWaker && (!data->m_awaiter || !data->m_awaiter.equals(*myWaker))) {
-                data->m_awaiter = myWaker->clone();
-            }
-
-            return std::nullopt;
         }
+
+        // register and check again, in case the task completed in between
+        m_awaiter.registerWaker(cx);
+        return this->takeResult();
     }
 
 private:
-    struct Data {
-        std::optional<T> m_result;
-        Waker m_awaiter;
-    };
-
     arc::MoveOnlyFunction<T()> m_func;
-    asp::SpinLock<Data> m_data;
+    std::optional<T> m_result;
+    std::atomic<bool> m_completed{false};
+    bool m_taken = false; // only accessed by the awaiting side
+    AtomicWaker m_awaiter;
 
-    static void vExecute(void* ptr) {
-        auto* task = static_cast<BlockingTask*>(ptr);
-        T result = task->m_func();
+    std::optional<T> takeResult() noexcept {
+        if (m_taken || !m_completed.load(std::memory_order::acquire)) {
+            return std::nullopt;
+        }
 
-        auto data = task->m_data.lock();
-        data->m_result = std::move(result);
+        m_taken = true;
+        auto out = std::move(*m_result);
+        m_result.reset();
+        return out;
+    }
 
-        if (data->m_awaiter) {
-            data->m_awaiter.wake();
-        }
+    static void vExecute(void* ptr) {
+        auto* task = static_cast<BlockingTask*>(ptr);
+        task->m_result = task->m_func();
+        task->m_completed.store(true, std::memory_order::release);
+        task->m_awaiter.wake();
     }
 
     static constexpr BlockingTaskVtable vtable = {
@@ -91,39 +88,25 @@ struct BlockingTask<void> : BlockingTaskBase {
         : BlockingTaskBase(std::move(runtime), &vtable), m_func(std::move(func)) {}
 
     bool pollTask(Context& cx) {
-        auto data = m_data.lock();
-
-        if (data->m_completed) {
+        if (m_completed.load(std::memory_order::acquire)) {
             return true;
-        } else {
-            auto myWaker = cx.waker();
-            if (myWaker && (!data->m_awaiter || !data->m_awaiter.equals(*myWaker))) {
-                data->m_awaiter = myWaker->clone();
-            }
-
-            return false;
         }
+
+        // register and check again, in case the task completed in between
+        m_awaiter.registerWaker(cx);
+        return m_completed.load(std::memory_order::acquire);
     }
 
 private:
-    struct Data {
-        bool m_completed = false;
-        Waker m_awaiter;
-    };
-
     arc::MoveOnlyFunction<void()> m_func;
-    asp::SpinLock<Data> m_data;
+    std::atomic<bool> m_completed{false};
+    AtomicWaker m_awaiter;
 
     static void vExecute(void* ptr) {
         auto* task = static_cast<BlockingTask*>(ptr);
         task->m_func();
-
-        auto data = task->m_data.lock();
-        data->m_completed = true;
-
-        if (data->m_awaiter) {
-            data->m_awaiter.wake();
-        }
+        task->m_completed.store(true, std::memory_order::release);
+        task->m_awaiter.wake();
     }
 
     static constexpr BlockingTaskVtable vtable = {
@@ -3,57 +3,141 @@
 #include <atomic>
 #include <arc/future/Pollable.hpp>
 #include <arc/sync/Notify.hpp>
+#include <asp/sync/Mutex.hpp>
+#include <asp/ptr/SharedPtr.hpp>
 
 namespace arc {
 
+/// Shared state of a cancellation token. Every node is a member of an intrusive tree,
+/// children are linked into their parent's list through their own sibling pointers, so linking a child does not allocate.
+/// The sibling pointers of a node are protected by the parent's mutex.
+struct CancellationState {
+    CancellationState() = default;
+    explicit CancellationState(asp::SharedPtr<CancellationState> parent) noexcept;
+    ~CancellationState();
+
+    CancellationState(const CancellationState&) = delete;
+    CancellationState& operator=(const CancellationState&) = delete;
+
+    std::atomic<bool> m_cancelled{false};
+    Notify m_notify;
+
+    bool isCancelled() const noexcept;
+
+    /// Cancels this node and all of its descendants in a single traversal
+    void cancel() noexcept;
+
+private:
+    asp::SharedPtr<CancellationState> m_parent;
+    asp::Mutex<CancellationState*> m_firstChild{nullptr};
+    CancellationState* m_prevSibling = nullptr;
+    CancellationState* m_nextSibling = nullptr;
+};
+
+/// A token that can be used to signal cancellation to any number of tasks.
+/// Tokens are cheap to copy, and all copies refer to the same state.
+/// Child tokens can be created with `child()`, cancelling a token cancels all of its descendants,
+/// but cancelling a child has no effect on the parent.
 struct CancellationToken {
-    CancellationToken() = default;
+    CancellationToken();
+
+    CancellationToken(const CancellationToken&) = default;
+    CancellationToken& operator=(const CancellationToken&) = default;
+    CancellationToken(CancellationToken&&) noexcept = default;
+    CancellationToken& operator=(CancellationToken&&) noexcept = default;
 
-    CancellationToken(CancellationToken&&) = delete;
-    CancellationToken& operator=(CancellationToken&&) = delete;
+    /// Creates a new token that gets cancelled when this token is cancelled.
+    /// If this token is already cancelled, the child starts out cancelled.
+    CancellationToken child() const;
 
     bool isCancelled() const noexcept {
-        return m_cancelled.load(std::memory_order::acquire);
+        return m_state->isCancelled();
     }
 
-    void cancel() noexcept {
-        m_cancelled.store(true, std::memory_order::release);
-        m_notify.notifyAll();
+    /// Cancels this token and all of its children, waking up every task that waits on any of them.
+    void cancel() const noexcept {
+        m_state->cancel();
     }
 
     struct ARC_NODISCARD Awaiter : Pollable<Awaiter> {
-        explicit Awaiter(CancellationToken* token) : m_token(token) {}
+        explicit Awaiter(asp::SharedPtr<CancellationState> state) : m_state(std::move(state)) {}
         Awaiter(Awaiter&&) noexcept = default;
         Awaiter& operator=(Awaiter&&) noexcept = delete;
         ~Awaiter() = default;
 
         bool poll(Context& cx) {
-            if (m_token->isCancelled()) {
+            if (!m_notified) {
+                // create the Notified before checking the flag, a later cancel will then always complete it
+                m_notified.emplace(m_state->m_notify.notified());
+            }
+
+            if (m_state->isCancelled()) {
                 return true;
             }
 
-            if (!m_notified) {
-                m_notified.emplace(m_token->m_notify.notified());
-                if (m_notified->poll(cx)) {
-                    return true;
+            return m_notified->poll(cx);
+        }
+
+    private:
+        asp::SharedPtr<CancellationState> m_state;
+        std::optional<Notified> m_notified;
+    };
+
+    template <
+        IsPollable Fut,
+        typename FutOut = typename FutureTraits<std::decay_t<Fut>>::Output,
+        bool IsVoid = std::is_void_v<FutOut>,
+        typename Output = std::optional<std::conditional_t<IsVoid, std::monostate, FutOut>>
+    >
+    struct ARC_NODISCARD RunUntilCancelled : Pollable<RunUntilCancelled<Fut>, Output> {
+        explicit RunUntilCancelled(Fut fut, Awaiter cancelled) noexcept
+            : m_future(std::move(fut)), m_cancelled(std::move(cancelled)) {}
+
+        RunUntilCancelled(RunUntilCancelled&&) noexcept = default;
+        RunUntilCancelled& operator=(RunUntilCancelled&&) noexcept = delete;
+
+        std::optional<Output> poll(Context& cx) {
+            // cancellation is checked first, so a cancelled token never lets the future make progress
+            if (m_cancelled.poll(cx)) {
+                return Output{std::nullopt};
+            }
+
+            auto vt = m_future.m_vtable;
+            if (vt->m_poll(&m_future, cx)) {
+                if constexpr (IsVoid) {
+                    // propagate exceptions
+                    vt->template getOutput<void>(&m_future);
+                    return Output{std::monostate{}};
+                } else {
+                    return Output{std::move(vt->template getOutput<FutOut>(&m_future))};
                 }
             }
 
-            return m_token->isCancelled();
+            return std::nullopt;
         }
 
     private:
-        CancellationToken* m_token;
-        std::optional<Notified> m_notified;
+        Fut m_future;
+        Awaiter m_cancelled;
     };
 
-    Awaiter waitCancelled() noexcept {
-        return Awaiter{this};
+    /// Returns a future that completes once this token is cancelled.
+    Awaiter waitCancelled() const noexcept {
+        return Awaiter{m_state};
+    }
+
+    /// Runs the given future until it completes or until the token is cancelled.
+    /// On cancellation the future is dropped, which aborts whatever it was waiting on (a sleep, a socket read, etc.),
+    /// and the result is `std::nullopt`. For futures returning void, the output is `std::optional<std::monostate>`.
+    template <IsPollable Fut>
+    RunUntilCancelled<Fut> runUntilCancelled(Fut fut) const noexcept {
+        return RunUntilCancelled<Fut>{std::move(fut), this->waitCancelled()};
     }
 
 private:
-    std::atomic<bool> m_cancelled{false};
-    arc::Notify m_notify;
+    asp::SharedPtr<CancellationState> m_state;
+
+    explicit CancellationToken(asp::SharedPtr<CancellationState> state) noexcept : m_state(std::move(state)) {}
 };
 
-}
\ No newline at end of file
+}
@@ -1,12 +1,13 @@
 #pragma once
-#include <condition_variable>
-#include <mutex>
+#include "Parker.hpp"
 #include "Waker.hpp"
 
 namespace arc {
 
-/// A wrapper around a condition variable to be used as a waker,
+/// A waker that unparks the thread that created it,
 /// used for blocking until a task is complete.
+/// Waking stores a token, so a wake that happens right before `wait()` is not lost,
+/// and neither side makes a syscall unless the thread actually needs to sleep.
 struct CondvarWaker {
 public:
     CondvarWaker() = default;
@@ -32,27 +33,17 @@ public:
         return Waker{this, &vtable};
     }
 
+    /// Blocks until woken, consuming the wakeup.
     void wait() noexcept {
-        std::unique_lock lock(mtx);
-        while (!notified) {
-            cv.wait(lock);
-        }
+        m_parker.park();
     }
 
     void notify() noexcept {
-        std::unique_lock lock(mtx);
-        notified = true;
-        cv.notify_one();
-    }
-
-    std::unique_lock<std::mutex> lock() noexcept {
-        return std::unique_lock{mtx};
+        m_parker.unpark();
     }
 
 private:
-    std::condition_variable cv;
-    std::mutex mtx;
-    bool notified = false;
+    Parker m_parker;
 };
 
-}
\ No newline at end of file
+}
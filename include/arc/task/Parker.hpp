@@ -0,0 +1,50 @@
+#pragma once
+#include <asp/time/Duration.hpp>
+#include <atomic>
+#include <cstdint>
+
+#if !defined(__linux__) && !defined(_WIN32)
+# include <condition_variable>
+# include <mutex>
+#endif
+
+namespace arc {
+
+/// A thread parker, allows a thread to block until another thread unparks it.
+/// Unparking stores a single token, so an `unpark()` that happens before `park()` is never lost.
+/// Uses a futex on Linux and WaitOnAddress on Windows, and neither side makes a syscall
+/// if the token is already present or nobody is parked.
+struct Parker {
+    Parker() noexcept = default;
+    Parker(const Parker&) = delete;
+    Parker& operator=(const Parker&) = delete;
+    Parker(Parker&&) = delete;
+    Parker& operator=(Parker&&) = delete;
+
+    /// Blocks the current thread until unparked, consuming the token. Returns immediately if a token is present.
+    void park() noexcept;
+
+    /// Like `park()`, but gives up after the timeout. Returns whether the thread was unparked.
+    bool parkTimeout(asp::time::Duration timeout) noexcept;
+
+    /// Unparks the parked thread, or stores a token so the next park returns immediately.
+    void unpark() noexcept;
+
+private:
+    static constexpr int32_t EMPTY = 0;
+    static constexpr int32_t NOTIFIED = 1;
+    static constexpr int32_t PARKED = -1;
+
+    std::atomic<int32_t> m_state{EMPTY};
+
+#if !defined(__linux__) && !defined(_WIN32)
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+#endif
+
+    /// Blocks while the state is PARKED, may return spuriously
+    void wait(const asp::time::Duration* timeout) noexcept;
+    void wake() noexcept;
+};
+
+}
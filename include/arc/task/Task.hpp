@@ -9,6 +9,7 @@
 #include <arc/util/ScopeDtor.hpp>
 #include <arc/util/Assert.hpp>
 #include <arc/util/Config.hpp>
+#include <arc/util/Pool.hpp>
 
 #include <asp/ptr/SharedPtr.hpp>
 #include <asp/sync/SpinLock.hpp>
@@ -73,10 +74,23 @@ struct TaskVtable {
     GetDebugDataFn getDebugData;
 };
 
-struct TaskBase {
+/// Fields that most tasks never touch. They are allocated the first time any of them is needed,
+/// so a task that is never awaited, named or failed only pays for the hot header below.
+struct TaskColdData : pool::Pooled {
+    Waker awaiter;
+    asp::BoxedString name;
+    asp::SharedPtr<TaskDebugData> debugData;
+    std::exception_ptr exception;
+};
+
+/// Tasks are allocated from the thread-local pools, since they are created and destroyed at a high rate
+struct TaskBase : pool::Pooled {
     void abort() noexcept;
     void setName(asp::BoxedString name) noexcept;
     asp::SharedPtr<TaskDebugData> getDebugData() noexcept;
+    /// Overrides the runtime's cooperative budget for this task, 0 goes back to the runtime default.
+    /// Takes effect the next time the task is polled.
+    void setCoopBudget(uint32_t budget) noexcept;
 
     // Every field past the vtable can be changed without causing an ABI break.
     // Fields must never be directly accessed and should only be used through the vtable.
@@ -84,6 +98,7 @@ struct TaskBase {
 
 protected:
     friend class Runtime;
+    friend class TaskRegistry;
     template <typename T>
     friend struct TaskHandleBase;
 
@@ -93,12 +108,25 @@ protected:
     TaskBase(const TaskBase&) = delete;
     TaskBase& operator=(const TaskBase&) = delete;
 
+    ~TaskBase();
+
+    // The hot header: everything touched on every schedule and poll sits together at the start,
+    // everything else lives in the lazily allocated cold block.
     std::atomic<uint64_t> m_state{TASK_INITIAL_STATE};
     Runtime* m_runtime;
-    Waker m_awaiter;
-    asp::BoxedString m_name;
-    asp::SharedPtr<TaskDebugData> m_debugData;
-    std::exception_ptr m_exception;
+    std::atomic<TaskColdData*> m_cold{nullptr};
+
+    // intrusive links into the runtime's task registry, protected by the registry shard lock
+    TaskBase* m_registryPrev = nullptr;
+    TaskBase* m_registryNext = nullptr;
+    std::atomic<uint32_t> m_registryShard{UINT32_MAX};
+    // fills the padding after the shard index, 0 means the runtime default
+    std::atomic<uint32_t> m_coopBudget{0};
+
+    /// Returns the cold block, or nullptr if it was never allocated
+    TaskColdData* coldData() const noexcept;
+    /// Returns the cold block, allocating it if needed. Safe to call from multiple threads at once.
+    TaskColdData& ensureColdData();
 
     static bool shouldDestroy(uint64_t state) noexcept;
     uint64_t incref() noexcept;
@@ -130,6 +158,11 @@ protected:
     static std::optional<bool> vPoll(void* self, Context& cx);
 };
 
+// With 64-bit pointers, an idle task costs 56 bytes of header, the 16-byte pool block header,
+// and the size of its future and lambda. The cold block (another ~48 bytes) is only added once the task is
+// awaited, named, fails or has debug data. Keep this in sync if the header grows.
+static_assert(sizeof(void*) != 8 || sizeof(TaskBase) <= 56, "TaskBase grew, update the documented per-task overhead");
+
 template <typename T>
 struct TaskTypedBase : TaskBase {
     using Output = T;
@@ -139,7 +172,11 @@ struct TaskTypedBase : TaskBase {
 
     std::optional<NVOutput> detach() {
         MaybeUninit<NVOutput> out;
+#ifdef ARC_STATIC_DISPATCH
+        bool grabbed = TaskTypedBase::vDetach(this, &out);
+#else
         bool grabbed = m_vtable->detach(this, &out);
+#endif
         return grabbed ? std::optional{std::move(out).assumeInit()} : std::nullopt;
     }
 
@@ -232,8 +269,8 @@ public:
     }
 
     ~Task() {
-        if (this->m_debugData) {
-            this->m_debugData->m_task.store(nullptr, std::memory_order::release);
+        if (auto cold = this->coldData(); cold && cold->debugData) {
+            cold->debugData->m_task.store(nullptr, std::memory_order::release);
         }
 
         if (!m_droppedFuture.load(std::memory_order::acquire)) {
@@ -327,9 +364,9 @@ protected:
     /// This should only be called after a vPoll returns true, and not more than once.
     static void vGetOutput(void* ptr, void* out) {
         auto self = static_cast<Task*>(ptr);
-        if (self->m_exception) {
+        if (auto cold = self->coldData(); cold && cold->exception) {
             ARC_TRACE("[{}] rethrowing exception from task", self->debugName());
-            std::rethrow_exception(self->m_exception);
+            std::rethrow_exception(cold->exception);
         }
 
         if constexpr (!IsVoid) {
@@ -367,7 +404,7 @@ protected:
 
 #ifdef ARC_DEBUG
         this->ensureDebugData();
-        this->m_debugData->m_polls.fetch_add(1, std::memory_order::relaxed);
+        this->coldData()->debugData->m_polls.fetch_add(1, std::memory_order::relaxed);
 #endif
 
         // update task state
@@ -403,6 +440,10 @@ protected:
         auto startTime = asp::Instant::now();
 #endif
 
+        if (auto budget = m_coopBudget.load(std::memory_order::relaxed)) {
+            cx._setBudget(budget);
+        }
+
         PollableBase* future = &m_future.get();
         cx._installWaker(&waker.get());
         bool result = future->m_vtable->m_poll(future, cx);
@@ -410,7 +451,7 @@ protected:
 
 #ifdef ARC_DEBUG
         uint64_t taken = startTime.elapsed().nanos();
-        this->m_debugData->m_runtimeNs.fetch_add(taken, std::memory_order::relaxed);
+        this->coldData()->debugData->m_runtimeNs.fetch_add(taken, std::memory_order::relaxed);
 #endif
 
         ARC_TRACE("[{}] future completion: {}", this->debugName(), result);
@@ -424,7 +465,7 @@ protected:
                     if (func) func(future, nullptr);
                 }
             } catch (const std::exception& e) {
-                this->m_exception = std::current_exception();
+                this->ensureColdData().exception = std::current_exception();
 
                 printError("[{}] Task terminated due to exception: {}", this->debugName(), e.what());
                 cx.dumpStack();
@@ -533,7 +574,11 @@ struct TaskHandleBase {
     /// If the task is completed or threw, invalidates this handle.
     std::optional<typename TaskTypedBase<T>::NVOutput> pollTask(Context& cx) {
         this->validate();
+#ifdef ARC_STATIC_DISPATCH
+        auto res = TaskBase::vPoll(m_task, cx);
+#else
         auto res = m_task->m_vtable->poll(m_task, cx);
+#endif
         ARC_TRACE("[{}] poll result: {}", this->m_task->debugName(), res);
 
         if (res && *res) {
@@ -602,6 +647,14 @@ struct TaskHandleBase {
         return m_task->getDebugData();
     }
 
+    /// Sets how many resource operations the task may complete per poll before being forced to yield,
+    /// overriding `RuntimeOptions::coopBudget`. Pass `Context::UNCONSTRAINED_BUDGET` to never force a yield,
+    /// or 0 to go back to the runtime default.
+    void setCoopBudget(uint32_t budget) {
+        this->validate();
+        m_task->setCoopBudget(budget);
+    }
+
     /// Checks if the handle is valid (i.e. it points to a task that hasn't been detached yet).
     bool isValid() const noexcept {
         return m_task != nullptr;
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <asp/sync/SpinLock.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace arc {
+
+struct TaskBase;
+
+/// Set of all tasks owned by a runtime. Tasks are linked intrusively, so inserting and removing never allocates,
+/// and the list is split into shards to avoid a single lock that every spawn and every task destruction would contend on.
+/// A task is inserted into the shard of the thread that spawned it, and removed from the same shard, whichever thread that happens on.
+class TaskRegistry {
+public:
+    explicit TaskRegistry(size_t shards);
+    ~TaskRegistry();
+
+    TaskRegistry(const TaskRegistry&) = delete;
+    TaskRegistry& operator=(const TaskRegistry&) = delete;
+
+    void insert(TaskBase* task) noexcept;
+
+    /// Removes the task, does nothing if it was already taken out with `takeAll`
+    void remove(TaskBase* task) noexcept;
+
+    /// Calls `func` with every registered task. Each shard is locked while it is being visited,
+    /// so `func` must not insert or remove tasks.
+    template <typename F>
+    void forEach(F&& func) {
+        for (size_t i = 0; i < m_shardCount; i++) {
+            auto shard = m_shards[i].data.lock();
+            for (auto task = shard->head; task; task = nextOf(task)) {
+                func(task);
+            }
+        }
+    }
+
+    /// Returns the number of registered tasks. Since shards are counted one by one, this is approximate under concurrent modification.
+    size_t size() const noexcept;
+
+    /// Unregisters every task and returns them as a chain, which can be walked with `nextOf`.
+    /// Tasks in the chain are detached, removing them later is a no-op.
+    TaskBase* takeAll() noexcept;
+
+    static TaskBase* nextOf(TaskBase* task) noexcept;
+
+private:
+    struct ShardData {
+        TaskBase* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct alignas(64) Shard {
+        asp::SpinLock<ShardData> data;
+    };
+
+    size_t m_shardCount;
+    std::unique_ptr<Shard[]> m_shards;
+
+    uint32_t currentShard() const noexcept;
+};
+
+}
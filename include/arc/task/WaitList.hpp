@@ -1,11 +1,37 @@
 #pragma once
 
 #include "Waker.hpp"
-#include <deque>
+#include <arc/util/Assert.hpp>
 #include <optional>
+#include <cstddef>
 
 namespace arc {
 
+/// Intrusive node of a WaitList, awaiters that want to wait on a WaitList must publicly inherit from this.
+/// The node stores the registered waker, so waiting does not allocate.
+/// Moving an awaiter never moves the links, the new node always starts unlinked.
+struct WaitListNode {
+    WaitListNode() noexcept = default;
+    WaitListNode(WaitListNode&&) noexcept {}
+    WaitListNode& operator=(WaitListNode&&) = delete;
+
+    bool isLinked() const noexcept {
+        return m_linked;
+    }
+
+private:
+    template <typename T>
+    friend struct WaitList;
+
+    WaitListNode* m_prev = nullptr;
+    WaitListNode* m_next = nullptr;
+    Waker m_waker;
+    bool m_linked = false;
+};
+
+/// Intrusive doubly-linked list of waiters. T must derive from WaitListNode.
+/// All operations besides forAll and takeIf are O(1), and none of them allocate.
+/// The list does not own the awaiters, they must remove themselves before being destroyed.
 template <typename T>
 struct WaitList {
     struct Waiter {
@@ -13,60 +39,163 @@ struct WaitList {
         T* awaiter;
     };
 
+    WaitList() noexcept = default;
+    WaitList(const WaitList&) = delete;
+    WaitList& operator=(const WaitList&) = delete;
+
+    ~WaitList() {
+        ARC_DEBUG_ASSERT(!m_head, "WaitList destroyed with waiters still linked");
+    }
+
+    /// Adds the awaiter to the back of the list. If the node already holds an equal waker, it is reused.
     void add(const Waker& waker, T* awaiter) noexcept {
-        m_waiters.push_back({
-            waker.clone(),
-            awaiter,
-        });
+        WaitListNode* node = toNode(awaiter);
+        this->prepare(node, waker);
+
+        node->m_prev = m_tail;
+        node->m_next = nullptr;
+
+        if (m_tail) {
+            m_tail->m_next = node;
+        } else {
+            m_head = node;
+        }
+
+        m_tail = node;
     }
 
-    void remove(T* awaiter) noexcept {
-        for (auto it = m_waiters.begin(); it != m_waiters.end(); ++it) {
-            if (it->awaiter == awaiter) {
-                m_waiters.erase(it);
-                return;
-            }
+    /// Adds the awaiter to the front of the list, so it will be the next one to be taken.
+    void addFront(const Waker& waker, T* awaiter) noexcept {
+        WaitListNode* node = toNode(awaiter);
+        this->prepare(node, waker);
+
+        node->m_prev = nullptr;
+        node->m_next = m_head;
+
+        if (m_head) {
+            m_head->m_prev = node;
+        } else {
+            m_tail = node;
         }
+
+        m_head = node;
     }
 
-    void swapData(T* old, T* newAddr) noexcept {
-        for (auto& waiter : m_waiters) {
-            if (waiter.awaiter == old) {
-                waiter.awaiter = newAddr;
-                return;
-            }
+    /// Removes the awaiter from the list, returns false if it was not linked.
+    bool remove(T* awaiter) noexcept {
+        WaitListNode* node = toNode(awaiter);
+        if (!node->m_linked) {
+            return false;
         }
+
+        this->unlink(node);
+        return true;
     }
 
-    std::optional<Waiter> takeFirst() {
-        if (m_waiters.empty()) {
+    /// Removes the first awaiter from the list and returns it along with its waker.
+    /// The waker is moved out of the node, so it's safe to use even after the awaiter is destroyed.
+    std::optional<Waiter> takeFirst() noexcept {
+        if (!m_head) {
             return std::nullopt;
         }
 
-        auto waiter = std::move(m_waiters.front());
-        m_waiters.pop_front();
-        return waiter;
+        WaitListNode* node = m_head;
+        this->unlink(node);
+
+        return Waiter{std::move(node->m_waker), toAwaiter(node)};
     }
 
-    Waiter* first() noexcept {
-        if (m_waiters.empty()) {
-            return nullptr;
-        }
+    T* first() noexcept {
+        return m_head ? toAwaiter(m_head) : nullptr;
+    }
 
-        return &m_waiters.front();
+    bool empty() const noexcept {
+        return m_head == nullptr;
+    }
+
+    size_t size() const noexcept {
+        return m_size;
     }
 
     /// Calls the given function on all waiters and clears the list.
+    /// Every node is unlinked before the function is called on it, so the function may destroy the awaiter.
     template <typename Func>
     void forAll(Func&& func) {
-        for (auto& waiter : m_waiters) {
-            func(waiter.waker, waiter.awaiter);
+        while (auto waiter = this->takeFirst()) {
+            func(waiter->waker, waiter->awaiter);
+        }
+    }
+
+    /// Calls the given function on every waiter in order, without removing any of them.
+    template <typename Func>
+    void forEach(Func&& func) {
+        for (WaitListNode* node = m_head; node; node = node->m_next) {
+            func(toAwaiter(node));
+        }
+    }
+
+    /// Removes all waiters matching the predicate, calling the given function on each removed waiter.
+    /// The relative order of the remaining waiters is preserved.
+    template <typename Pred, typename Func>
+    void takeIf(Pred&& pred, Func&& func) {
+        WaitListNode* node = m_head;
+
+        while (node) {
+            WaitListNode* next = node->m_next;
+            T* awaiter = toAwaiter(node);
+
+            if (pred(awaiter)) {
+                this->unlink(node);
+                Waker waker = std::move(node->m_waker);
+                func(waker, awaiter);
+            }
+
+            node = next;
         }
-        m_waiters.clear();
     }
 
 private:
-    std::deque<Waiter> m_waiters;
+    WaitListNode* m_head = nullptr;
+    WaitListNode* m_tail = nullptr;
+    size_t m_size = 0;
+
+    static WaitListNode* toNode(T* awaiter) noexcept {
+        return static_cast<WaitListNode*>(awaiter);
+    }
+
+    static T* toAwaiter(WaitListNode* node) noexcept {
+        return static_cast<T*>(node);
+    }
+
+    void prepare(WaitListNode* node, const Waker& waker) noexcept {
+        ARC_DEBUG_ASSERT(!node->m_linked, "awaiter is already in a WaitList");
+
+        if (!node->m_waker || !node->m_waker.equals(waker)) {
+            node->m_waker = waker.clone();
+        }
+
+        node->m_linked = true;
+        m_size++;
+    }
+
+    void unlink(WaitListNode* node) noexcept {
+        if (node->m_prev) {
+            node->m_prev->m_next = node->m_next;
+        } else {
+            m_head = node->m_next;
+        }
+
+        if (node->m_next) {
+            node->m_next->m_prev = node->m_prev;
+        } else {
+            m_tail = node->m_prev;
+        }
+
+        node->m_prev = nullptr;
+        node->m_next = nullptr;
+        node->m_linked = false;
+        m_size--;
+    }
 };
 
-}
\ No newline at end of file
+}
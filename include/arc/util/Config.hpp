@@ -6,6 +6,9 @@
 # define ARC_NO_UNIQUE_ADDRESS [[no_unique_address]]
 #endif
 
+// ARC_STATIC_DISPATCH is defined by the STATIC_DISPATCH feature. When it is, calls that would go through
+// an ABI vtable but always resolve to the same function are made directly, see README for more details.
+
 #define ARC_FATAL_NO_FEATURE(feat) \
     static_assert(false, \
         "\n\nError: an Arc header was included that requires the feature: " #feat "\n" \
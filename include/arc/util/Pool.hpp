@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace arc::pool {
+
+/// Largest allocation size that is served from the pools, anything bigger goes straight to `operator new`.
+static constexpr size_t MAX_POOLED_SIZE = 4096;
+
+/// Allocates memory from the calling thread's pool, aligned to `alignof(std::max_align_t)`.
+/// Allocations are grouped into power-of-two size classes, and every thread keeps a free list per class,
+/// so recurring allocations of similar sizes are recycled without touching the global allocator.
+void* allocate(size_t size);
+
+/// Returns memory obtained from `allocate` to its pool. This can be called from any thread:
+/// memory freed on the owning thread goes back to its local free list,
+/// while memory freed on another thread is handed back to the owner through a lock-free stack.
+void deallocate(void* ptr) noexcept;
+
+struct Stats {
+    /// Allocations served from a free list
+    size_t hits = 0;
+    /// Allocations that had to go to the global allocator, including ones too large to be pooled
+    size_t misses = 0;
+};
+
+/// Returns the allocation counters of the calling thread.
+Stats threadStats() noexcept;
+
+/// Allocator interface for classes that want to be allocated from the pool, inherit from this to use it.
+struct Pooled {
+    static void* operator new(size_t size) {
+        return pool::allocate(size);
+    }
+
+    static void operator delete(void* ptr) noexcept {
+        pool::deallocate(ptr);
+    }
+
+    // over-aligned types are rare, they simply use the global allocator
+    static void* operator new(size_t size, std::align_val_t align) {
+        return ::operator new(size, align);
+    }
+
+    static void operator delete(void* ptr, std::align_val_t align) noexcept {
+        ::operator delete(ptr, align);
+    }
+};
+
+}
@@ -47,26 +47,25 @@ void Context::_installWaker(Waker* waker) noexcept {
 }
 
 
-void Context::setup(Instant taskDeadline) noexcept {
-    m_taskDeadline = taskDeadline.rawNanos();
-    m_futurePolls = 0;
+
+void Context::setup(uint32_t budget) noexcept {
+    m_budget = budget;
     m_unused = nullptr;
-    m_stack.clear();
-    m_capturedStack.clear();
-    m_stack.reserve(32);
+    m_chain = nullptr;
+
+    if (!m_stack.empty()) m_stack.clear();
+    if (!m_stackChains.empty()) m_stackChains.clear();
+    if (!m_capturedStack.empty()) m_capturedStack.clear();
 }
 
 bool Context::shouldCoopYield() noexcept {
-    // try to make this check as cheap as possible
-    m_futurePolls++;
-    if (m_futurePolls % 64 == 0) {
-        return m_taskDeadline > 0 && Instant::now().rawNanos() >= m_taskDeadline;
-    }
-    return false;
+    return !this->consumeBudget();
 }
 
 void Context::pushFrame(const PollableBase* pollable) {
     // ARC_TRACE("pushing frame {}", (void*)pollable);
+    m_stackChains.resize(m_stack.size(), nullptr);
+    m_stackChains.push_back(m_chain);
     m_stack.push_back(StackEntry { pollable, {} });
     ARC_DEBUG_ASSERT(m_stack.size() < MAX_RECURSION_DEPTH, "maximum future recursion depth exceeded");
 }
@@ -75,9 +74,19 @@ void Context::popFrame() noexcept {
     ARC_DEBUG_ASSERT(!m_stack.empty(), "popFrame() called on empty future stack");
     // ARC_TRACE("popping frame {}", (void*)&m_stack.back());
     m_stack.pop_back();
+
+    if (m_stackChains.size() > m_stack.size()) {
+        m_stackChains.resize(m_stack.size());
+    }
 }
 
 void Context::markFrame(asp::UniqueBoxedString name) noexcept {
+    // coroutines in a chain don't push frames, so name the innermost running one directly
+    if (m_chain) {
+        m_chain->leaf->m_frameName = std::move(name);
+        return;
+    }
+
     if (m_stack.empty()) {
         return;
     }
@@ -109,12 +118,10 @@ static std::string dllFromPollable(const PollableBase* pollable);
 void Context::captureStack() {
     m_capturedStack.clear();
 
-    for (auto it = m_stack.rbegin(); it != m_stack.rend(); ++it) {
-        auto pollable = it->pollable;
-        auto& marker = it->name;
+    auto describe = [&](const PollableBase* pollable, std::string_view marker) {
         auto meta = pollable->m_vtable->m_metadata;
 
-        std::string description{marker.view()};
+        std::string description{marker};
         if (description.empty()) {
             auto dll = dllFromPollable(pollable);
 
@@ -146,8 +153,32 @@ void Context::captureStack() {
 #endif
 
         m_capturedStack.push_back(asp::UniqueBoxedString{description});
+    };
+
+    // frames pushed explicitly are listed right above the chain that was running when they were pushed
+    auto describeExplicit = [&](const ChainRoot* chain) {
+        for (size_t i = m_stack.size(); i-- > 0;) {
+            auto entryChain = i < m_stackChains.size() ? m_stackChains[i] : nullptr;
+            if (entryChain == chain) {
+                describe(m_stack[i].pollable, m_stack[i].name.view());
+            }
+        }
+    };
+
+    // futures don't push frames, so the stack is reconstructed from the links between them:
+    // each chain is walked from its leaf up to its root, then continues with the chain that polled that root
+    for (auto chain = m_chain; chain; chain = chain->outer) {
+        describeExplicit(chain);
+
+        for (auto promise = chain->leaf; promise; promise = promise->m_parent) {
+            // the parent's child is the future object that this coroutine belongs to
+            auto future = promise->m_parent ? promise->m_parent->getChild() : chain->future;
+            describe(future, promise->m_frameName.view());
+        }
     }
 
+    describeExplicit(nullptr);
+
     ARC_TRACE("Captured {} frames", m_capturedStack.size());
 }
 
@@ -45,6 +45,10 @@ Future<NetResult<std::pair<arc::TcpStream, qsox::SocketAddress>>> TcpListener::a
 }
 
 std::optional<TcpListener::PollAcceptResult> TcpListener::pollAccept(Context& cx, uint64_t& id) {
+    if (!cx.pollBudget()) {
+        return std::nullopt;
+    }
+
     while (true) {
         auto ready = m_io.pollReady(Interest::Readable, cx, id);
         if ((ready & Interest::Readable) == 0) {
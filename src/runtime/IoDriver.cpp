@@ -112,27 +112,51 @@ IoDriver::IoDriver(asp::WeakPtr<Runtime> runtime) : m_runtime(std::move(runtime)
 IoDriver::~IoDriver() {}
 
 Registration IoDriver::registerIo(SockFd fd, Interest interest) {
+#ifdef ARC_STATIC_DISPATCH
+    return IoDriver::vRegisterIo(this, fd, interest);
+#else
     return m_vtable->m_registerIo(this, fd, interest);
+#endif
 }
 
 void IoDriver::dropRegistration(const Registration& rio) {
+#ifdef ARC_STATIC_DISPATCH
+    IoDriver::vDropRegistration(this, rio);
+#else
     m_vtable->m_dropRegistration(this, rio);
+#endif
 }
 
 void IoDriver::clearReadiness(IoEntry& rio, Interest interest) {
+#ifdef ARC_STATIC_DISPATCH
+    IoDriver::vClearReadiness(this, rio, interest);
+#else
     m_vtable->m_clearReadiness(this, rio, interest);
+#endif
 }
 
 Interest IoDriver::pollReady(IoEntry& rio, Interest interest, Context& cx, uint64_t& outId) {
+#ifdef ARC_STATIC_DISPATCH
+    return IoDriver::vPollReady(this, rio, interest, cx, outId);
+#else
     return m_vtable->m_pollReady(this, rio, interest, cx, outId);
+#endif
 }
 
 void IoDriver::unregisterWaiter(IoEntry& rio, uint64_t id) {
+#ifdef ARC_STATIC_DISPATCH
+    IoDriver::vUnregisterWaiter(this, rio, id);
+#else
     m_vtable->m_unregisterWaiter(this, rio, id);
+#endif
 }
 
 SockFd IoDriver::fdForEntry(const IoEntry& rio) {
+#ifdef ARC_STATIC_DISPATCH
+    return IoDriver::vFdForEntry(rio);
+#else
     return m_vtable->m_fdForEntry(rio);
+#endif
 }
 
 // IoDriver actual impl
@@ -24,7 +24,11 @@ IocpDriver::~IocpDriver() {
 }
 
 Result<> IocpDriver::registerIo(WinHandle handle, IocpHandleContext* ctx, HandleType type) {
+#ifdef ARC_STATIC_DISPATCH
+    return IocpDriver::vRegisterIo(this, handle, ctx, type);
+#else
     return m_vtable->m_registerIo(this, handle, ctx, type);
+#endif
 }
 
 void IocpDriver::doWork() {
@@ -9,6 +9,7 @@ static constexpr size_t MAX_BLOCKING_WORKERS = 128;
 static constexpr size_t MIN_BLOCKING_WORKERS = 2;
 static thread_local arc::Runtime* g_runtime = nullptr;
 static arc::Runtime* g_globalRuntime = nullptr;
+static thread_local arc::WakeBatch* g_wakeBatch = nullptr;
 namespace arc {
 
 asp::SharedPtr<Runtime> Runtime::create(const RuntimeOptions& options) {
@@ -26,7 +27,7 @@ asp::SharedPtr<Runtime> Runtime::create(size_t workers) {
 Runtime::Runtime(ctor_tag, size_t workers)
     : m_stopFlag(false),
       m_workerCount(std::clamp<size_t>(workers, 1, 128)),
-      m_taskDeadline(Duration::fromMillis((uint64_t)(5.f * std::powf(m_workerCount, 0.9f))))
+      m_tasks(m_workerCount * 4)
 {
     static constexpr RuntimeVtable vtable = {
         .m_enqueueTask = &Runtime::vEnqueueTask,
@@ -38,6 +39,7 @@ Runtime::Runtime(ctor_tag, size_t workers)
         .m_safeShutdown = &Runtime::vSafeShutdown,
         .m_getDriver = &Runtime::vGetDriver,
         .m_getTaskStats = &Runtime::vGetTaskStats,
+        .m_enqueueTasks = &Runtime::vEnqueueTasks,
     };
 
     m_vtable = &vtable;
@@ -47,6 +49,8 @@ void Runtime::init(const RuntimeOptions& options) {
     // most of the initialization is deferred until here,
     // because weak_from_this() does not work inside constructor
 
+    m_coopBudget = options.coopBudget ? options.coopBudget : Context::UNCONSTRAINED_BUDGET;
+
 #ifdef ARC_FEATURE_TIME
     if (options.timeDriver) {
         m_timeDriver.emplace(weakFromThis());
@@ -72,6 +76,7 @@ void Runtime::init(const RuntimeOptions& options) {
     for (size_t i = 0; i < m_workerCount; ++i) {
         m_workers.emplace_back(WorkerData{
             .id = i,
+            .parker = std::make_unique<Parker>(),
         });
     }
 
@@ -94,15 +99,39 @@ Runtime* Runtime::current() {
 }
 
 void Runtime::setTerminateHandler(TerminateHandler handler) {
+#ifdef ARC_STATIC_DISPATCH
+    Runtime::vSetTerminateHandler(this, std::move(handler));
+#else
     m_vtable->m_setTerminateHandler(this, std::move(handler));
+#endif
 }
 
 void Runtime::enqueueTask(TaskBase* task) {
+#ifdef ARC_STATIC_DISPATCH
+    Runtime::vEnqueueTask(this, task);
+#else
     m_vtable->m_enqueueTask(this, task);
+#endif
+}
+
+void Runtime::enqueueTasks(TaskBase* const* tasks, size_t count) {
+    this->enqueueTasks(tasks, count, false);
+}
+
+void Runtime::enqueueTasks(TaskBase* const* tasks, size_t count, bool fromWorker) {
+#ifdef ARC_STATIC_DISPATCH
+    Runtime::vEnqueueTasks(this, tasks, count, fromWorker);
+#else
+    m_vtable->m_enqueueTasks(this, tasks, count, fromWorker);
+#endif
 }
 
 void Runtime::removeTask(TaskBase* task) noexcept {
+#ifdef ARC_STATIC_DISPATCH
+    Runtime::vRemoveTask(this, task);
+#else
     m_vtable->m_removeTask(this, task);
+#endif
 }
 
 void Runtime::vSetTerminateHandler(Runtime* self, TerminateHandler handler) noexcept {
@@ -112,15 +141,49 @@ void Runtime::vSetTerminateHandler(Runtime* self, TerminateHandler handler) noex
 
 void Runtime::vEnqueueTask(Runtime* self, TaskBase* task) {
     ARC_TRACE("[Runtime] enqueuing task {}", (void*)task);
+    WorkerData* idle = nullptr;
     {
         std::lock_guard lock(self->m_mtx);
         self->m_runQueue.push_back(task);
+
+        if (!self->m_idleWorkers.empty()) {
+            idle = self->m_idleWorkers.back();
+            self->m_idleWorkers.pop_back();
+        }
+    }
+
+    // wake exactly one parked worker, if there is none then every worker is busy and will pick the task up
+    if (idle) {
+        idle->parker->unpark();
+    }
+}
+
+void Runtime::vEnqueueTasks(Runtime* self, TaskBase* const* tasks, size_t count, bool fromWorker) {
+    if (count == 0) return;
+
+    ARC_TRACE("[Runtime] enqueuing {} tasks", count);
+    asp::SmallVec<WorkerData*, 16> idle;
+    {
+        std::lock_guard lock(self->m_mtx);
+        self->m_runQueue.insert(self->m_runQueue.end(), tasks, tasks + count);
+
+        // one worker per task at most, the rest of the idle workers stay parked.
+        // a worker flushing its own batch goes straight to the run queue afterwards, so it takes one task itself
+        size_t needed = fromWorker ? count - 1 : count;
+        size_t wake = (std::min)(needed, self->m_idleWorkers.size());
+        for (size_t i = 0; i < wake; i++) {
+            idle.emplace_back(self->m_idleWorkers.back());
+            self->m_idleWorkers.pop_back();
+        }
+    }
+
+    for (auto worker : idle) {
+        worker->parker->unpark();
     }
-    self->m_cv.notify_one();
 }
 
 void Runtime::vInsertTask(Runtime* self, TaskBase* task) {
-    self->m_tasks.lock()->insert(task);
+    self->m_tasks.insert(task);
 }
 
 void Runtime::vInsertBlocking(Runtime* self, asp::SharedPtr<BlockingTaskBase> task) {
@@ -134,7 +197,7 @@ void Runtime::vInsertBlocking(Runtime* self, asp::SharedPtr<BlockingTaskBase> ta
 }
 
 void Runtime::vRemoveTask(Runtime* self, TaskBase* task) noexcept {
-    self->m_tasks.lock()->erase(task);
+    self->m_tasks.remove(task);
 }
 
 bool Runtime::vIsShuttingDown(const Runtime* self) noexcept {
@@ -169,13 +232,12 @@ void* Runtime::vGetDriver(Runtime* self, DriverType ty) noexcept {
 }
 
 void Runtime::vGetTaskStats(Runtime* self, std::vector<asp::SharedPtr<TaskDebugData>>& out) {
-    auto tasks = self->m_tasks.lock();
-    out.reserve(tasks->size());
-    for (auto task : *tasks) {
+    out.reserve(self->m_tasks.size());
+    self->m_tasks.forEach([&](TaskBase* task) {
         if (auto data = task->getDebugData()) {
             out.push_back(std::move(data));
         }
-    }
+    });
 }
 
 void Runtime::workerLoopWrapper(WorkerData& data) {
@@ -251,38 +313,43 @@ void Runtime::workerLoop(WorkerData& data, Context& cx) {
         auto now = Instant::now();
         auto deadline = now + Duration::fromHours(1); // arbitrary long deadline
 
-        // every once in a while, run timer and io drivers
+        // every once in a while, run timer and io drivers.
+        // the tasks they wake are collected and enqueued together once both passes are done
+        {
+            WakeBatch wakes{this};
+
 #ifdef ARC_FEATURE_TIME
-        if (m_timeDriver && timerSched.tick(now)) {
-            m_timeDriver->doWork();
-        }
-        if (m_timeDriver) {
-            deadline = (std::min)(deadline, timerSched.next());
-        }
+            if (m_timeDriver && timerSched.tick(now)) {
+                m_timeDriver->doWork();
+            }
+            if (m_timeDriver) {
+                deadline = (std::min)(deadline, timerSched.next());
+            }
 #endif
 
 #if defined(ARC_FEATURE_NET) || defined(ARC_FEATURE_IOCP)
-        bool hasIoDriver = false;
+            bool hasIoDriver = false;
 # if defined(ARC_FEATURE_NET)
-        hasIoDriver = hasIoDriver || m_ioDriver.has_value();
+            hasIoDriver = hasIoDriver || m_ioDriver.has_value();
 # endif
 # if defined(ARC_FEATURE_IOCP)
-        hasIoDriver = hasIoDriver || m_iocpDriver.has_value();
+            hasIoDriver = hasIoDriver || m_iocpDriver.has_value();
 # endif
 
-        if (hasIoDriver) {
-            if (ioSched.tick(now)) {
+            if (hasIoDriver) {
+                if (ioSched.tick(now)) {
 #ifdef ARC_FEATURE_NET
-                if (m_ioDriver) m_ioDriver->doWork();
+                    if (m_ioDriver) m_ioDriver->doWork();
 #endif
 #ifdef ARC_FEATURE_IOCP
-                if (m_iocpDriver) m_iocpDriver->doWork();
+                    if (m_iocpDriver) m_iocpDriver->doWork();
 #endif
-            }
+                }
 
-            deadline = (std::min)(deadline, ioSched.next());
-        }
+                deadline = (std::min)(deadline, ioSched.next());
+            }
 #endif
+        }
 
         now = Instant::now();
         auto wait = deadline.durationSince(now);
@@ -290,19 +357,17 @@ void Runtime::workerLoop(WorkerData& data, Context& cx) {
         TaskBase* task = nullptr;
         {
             std::unique_lock lock(m_mtx);
-            bool success;
-
-            if (wait.isZero()) {
-                // don't wait
-                success = m_stopFlag.load(::acquire) || !m_runQueue.empty();
-            } else {
-                success = m_cv.wait_for(lock, std::chrono::microseconds{wait.micros()}, [this] {
-                    return m_stopFlag.load(::acquire) || !m_runQueue.empty();
-                });
-            }
 
-            if (!success) {
-                continue; // timeout
+            if (!wait.isZero() && m_runQueue.empty() && !m_stopFlag.load(::acquire)) {
+                // register as idle and park until a task is enqueued or the deadline passes.
+                // if an unpark happens between unlocking and parking, the token is stored and park returns immediately.
+                m_idleWorkers.push_back(&data);
+                lock.unlock();
+
+                data.parker->parkTimeout(wait);
+
+                lock.lock();
+                std::erase(m_idleWorkers, &data);
             }
 
             if (m_stopFlag.load(::acquire)) {
@@ -327,7 +392,7 @@ void Runtime::workerLoop(WorkerData& data, Context& cx) {
         ARC_TRACE("[Worker {}] driving task {}", data.id, taskName);
         now = Instant::now();
 
-        cx.setup(now + m_taskDeadline);
+        cx.setup(m_coopBudget);
         task->m_vtable->run(task, cx);
 
         ARC_TRACE("[Worker {}] finished driving task {}", data.id, taskName);
@@ -455,16 +520,28 @@ void Runtime::spawnBlockingWorker() {
 }
 
 bool Runtime::isShuttingDown() const noexcept {
+#ifdef ARC_STATIC_DISPATCH
+    return Runtime::vIsShuttingDown(this);
+#else
     return m_vtable->m_isShuttingDown(this);
+#endif
 }
 
 void Runtime::safeShutdown() {
+#ifdef ARC_STATIC_DISPATCH
+    Runtime::vSafeShutdown(this);
+#else
     m_vtable->m_safeShutdown(this);
+#endif
 }
 
 std::vector<asp::SharedPtr<TaskDebugData>> Runtime::getTaskStats() {
     std::vector<asp::SharedPtr<TaskDebugData>> out;
+#ifdef ARC_STATIC_DISPATCH
+    Runtime::vGetTaskStats(this, out);
+#else
     m_vtable->m_getTaskStats(this, out);
+#endif
     return out;
 }
 
@@ -474,7 +551,9 @@ void Runtime::shutdown() {
     }
 
     ARC_TRACE("[Runtime] shutting down");
-    m_cv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.parker->unpark();
+    }
     m_blockingCv.notify_all();
 
     for (auto& worker : m_workers) {
@@ -517,12 +596,44 @@ void Runtime::shutdown() {
 
     Context cx { nullptr };
 
-    auto tasks = m_tasks.lock();
-    for (auto* task : *tasks) {
+    // abort everything before running anything: once abandoned, a task no longer unregisters itself,
+    // and the reference taken by the abort keeps it alive until its own run, so the chain stays valid
+    auto tasks = m_tasks.takeAll();
+    for (auto task = tasks; task; task = TaskRegistry::nextOf(task)) {
         task->m_vtable->abort(task, true);
+    }
+
+    while (tasks) {
+        auto task = tasks;
+        tasks = TaskRegistry::nextOf(task);
         task->m_vtable->run(task, cx);
     }
-    tasks->clear();
+}
+
+WakeBatch::WakeBatch(Runtime* runtime) noexcept : m_runtime(runtime), m_prev(g_wakeBatch) {
+    g_wakeBatch = this;
+}
+
+WakeBatch::~WakeBatch() {
+    g_wakeBatch = m_prev;
+    this->flush();
+}
+
+void WakeBatch::flush() {
+    if (m_tasks.empty()) return;
+
+    m_runtime->enqueueTasks(m_tasks.data(), m_tasks.size(), g_runtime == m_runtime);
+    m_tasks.clear();
+}
+
+bool WakeBatch::tryPush(Runtime* runtime, TaskBase* task) {
+    auto batch = g_wakeBatch;
+    if (!batch || batch->m_runtime != runtime) {
+        return false;
+    }
+
+    batch->m_tasks.emplace_back(task);
+    return true;
 }
 
 void setGlobalRuntime(Runtime* rt) {
@@ -62,7 +62,11 @@ SignalDriver::SignalDriver(asp::WeakPtr<Runtime> runtime) : m_runtime(std::move(
 SignalDriver::~SignalDriver() {}
 
 Notify SignalDriver::addSignal(int signum) {
+#ifdef ARC_STATIC_DISPATCH
+    return SignalDriver::vAddSignal(this, signum);
+#else
     return m_vtable->m_addSignal(this, signum);
+#endif
 }
 
 Notify SignalDriver::vAddSignal(SignalDriver* self, int signum) {
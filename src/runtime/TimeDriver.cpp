@@ -56,11 +56,19 @@ void TimeDriver::doWork() {
 }
 
 uint64_t TimeDriver::addEntry(asp::time::Instant expiry, Waker waker) {
+#ifdef ARC_STATIC_DISPATCH
+    return TimeDriver::vAddEntry(this, expiry, std::move(waker));
+#else
     return m_vtable->m_addEntry(this, expiry, std::move(waker));
+#endif
 }
 
 void TimeDriver::removeEntry(asp::time::Instant expiry, uint64_t id) {
+#ifdef ARC_STATIC_DISPATCH
+    TimeDriver::vRemoveEntry(this, expiry, id);
+#else
     m_vtable->m_removeEntry(this, expiry, id);
+#endif
 }
 
 uint64_t TimeDriver::vAddEntry(TimeDriver* self, Instant expiry, Waker waker) {
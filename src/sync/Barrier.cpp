@@ -0,0 +1,82 @@
+#include <arc/sync/Barrier.hpp>
+#include <arc/util/Assert.hpp>
+#include <algorithm>
+
+using enum std::memory_order;
+using Awaiter = arc::Barrier::Awaiter;
+
+namespace arc {
+
+Barrier::Barrier(size_t n) : m_size(std::max<size_t>(n, 1)) {}
+
+Awaiter Barrier::wait() noexcept {
+    return Awaiter{*this};
+}
+
+Awaiter::Awaiter(Awaiter&& other) noexcept
+    : m_barrier(other.m_barrier),
+      m_generation(other.m_generation),
+      m_state(other.m_state)
+{
+    ARC_ASSERT(other.m_state != State::Waiting, "cannot move a Barrier awaiter that is already waiting");
+}
+
+Awaiter::~Awaiter() {
+    // always take the lock, the barrier may be in the middle of releasing us
+    if (m_state != State::Waiting) {
+        return;
+    }
+
+    auto state = m_barrier->m_state.lock();
+
+    // if still linked, the barrier has not completed yet, so take back our arrival
+    if (state->waiters.remove(this)) {
+        state->arrived--;
+    }
+}
+
+std::optional<BarrierWaitResult> Awaiter::poll(Context& cx) {
+    switch (m_state) {
+        case State::Init: {
+            auto state = m_barrier->m_state.lock();
+
+            if (++state->arrived < m_barrier->m_size) {
+                m_generation = m_barrier->m_generation.load(relaxed);
+                m_state = State::Waiting;
+                state->waiters.add(*cx.waker(), this);
+                return std::nullopt;
+            }
+
+            // we are the last one to arrive, release everyone in one go and start a new generation.
+            // the generation only changes once every waiter is unlinked, and waiters check it with the lock held
+            state->arrived = 0;
+            state->waiters.forAll([](Waker& waker, Awaiter*) {
+                waker.wake();
+            });
+            m_barrier->m_generation.fetch_add(1, release);
+
+            m_state = State::Done;
+            return BarrierWaitResult{true};
+        } break;
+
+        case State::Waiting: {
+            auto state = m_barrier->m_state.lock();
+
+            if (m_barrier->m_generation.load(acquire) == m_generation) {
+                return std::nullopt;
+            }
+
+            // already unlinked by the task that completed the barrier
+            m_state = State::Done;
+            return BarrierWaitResult{false};
+        } break;
+
+        case State::Done: {
+            return BarrierWaitResult{false};
+        } break;
+
+        default: std::unreachable();
+    }
+}
+
+}
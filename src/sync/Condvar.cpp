@@ -0,0 +1,58 @@
+#include <arc/sync/Condvar.hpp>
+
+using enum std::memory_order;
+
+namespace arc {
+
+void Condvar::notifyOne() noexcept {
+    // waiters register before unlocking the mutex, so a notifier that modified the state under the mutex always sees them
+    if (m_waiting.load(acquire) == 0) {
+        return;
+    }
+
+    auto waiters = m_waiters.lock();
+
+    if (auto w = waiters->takeFirst()) {
+        m_waiting.fetch_sub(1, relaxed);
+        w->awaiter->m_notified.store(true, release);
+        w->waker.wake();
+    }
+}
+
+void Condvar::notifyAll() noexcept {
+    if (m_waiting.load(acquire) == 0) {
+        return;
+    }
+
+    auto waiters = m_waiters.lock();
+    m_waiting.store(0, relaxed);
+
+    waiters->forAll([](Waker& waker, CondvarWaiter* waiter) {
+        waiter->m_notified.store(true, release);
+        waker.wake();
+    });
+}
+
+void Condvar::registerWaiter(CondvarWaiter* waiter, Context& cx) {
+    auto waiters = m_waiters.lock();
+    waiters->add(*cx.waker(), waiter);
+    m_waiting.fetch_add(1, release);
+}
+
+void Condvar::unregister(CondvarWaiter* waiter) noexcept {
+    auto waiters = m_waiters.lock();
+
+    if (waiters->remove(waiter)) {
+        m_waiting.fetch_sub(1, relaxed);
+    } else if (waiter->m_notified.load(acquire)) {
+        // we were picked by a notification but are going away without consuming it, pass it on.
+        // this may wake a task spuriously after a notifyAll, which condvar users must handle anyway
+        if (auto w = waiters->takeFirst()) {
+            m_waiting.fetch_sub(1, relaxed);
+            w->awaiter->m_notified.store(true, release);
+            w->waker.wake();
+        }
+    }
+}
+
+}
@@ -0,0 +1,72 @@
+#include <arc/sync/Latch.hpp>
+#include <arc/util/Assert.hpp>
+
+using enum std::memory_order;
+using Awaiter = arc::Latch::Awaiter;
+
+namespace arc {
+
+Latch::Latch(size_t count) : m_count(count) {}
+
+void Latch::countDown(size_t n) noexcept {
+    if (n == 0) return;
+
+    size_t prev = m_count.fetch_sub(n, acq_rel);
+    ARC_ASSERT(prev >= n, "Latch counted down past zero");
+
+    if (prev == n) {
+        // waiters recheck the count with the lock held, so nobody can slip in after this
+        m_waiters.lock()->forAll([](Waker& waker, Awaiter*) {
+            waker.wake();
+        });
+    }
+}
+
+Awaiter Latch::wait() noexcept {
+    return Awaiter{*this};
+}
+
+Awaiter Latch::arriveAndWait() noexcept {
+    this->countDown(1);
+    return Awaiter{*this};
+}
+
+bool Latch::tryWait() const noexcept {
+    return m_count.load(acquire) == 0;
+}
+
+size_t Latch::count() const noexcept {
+    return m_count.load(acquire);
+}
+
+Awaiter::Awaiter(Awaiter&& other) noexcept : m_latch(other.m_latch) {
+    ARC_ASSERT(!other.m_registered, "cannot move a Latch awaiter that is already waiting");
+}
+
+Awaiter::~Awaiter() {
+    // always take the lock, the latch may be in the middle of releasing us
+    if (m_registered) {
+        m_latch->m_waiters.lock()->remove(this);
+    }
+}
+
+bool Awaiter::poll(Context& cx) {
+    if (m_latch->tryWait()) {
+        return true;
+    }
+
+    if (m_registered) {
+        return false;
+    }
+
+    auto waiters = m_latch->m_waiters.lock();
+    if (m_latch->tryWait()) {
+        return true;
+    }
+
+    waiters->add(*cx.waker(), this);
+    m_registered = true;
+    return false;
+}
+
+}
@@ -7,23 +7,77 @@ using enum std::memory_order;
 
 namespace arc {
 
-bool NotifyState::claimStoredOrRegister(Notified* notified, Context& cx) {
-    auto waiters = m_waiters.lock();
-    if (m_storedPermit) {
-        m_storedPermit = false;
+size_t NotifyState::epoch() const noexcept {
+    return m_state.load(acquire) & EPOCH_MASK;
+}
+
+bool NotifyState::tryClaim(size_t epoch) noexcept {
+    size_t state = m_state.load(acquire);
+
+    while (true) {
+        if ((state & EPOCH_MASK) != epoch) {
+            return true;
+        }
+
+        if (!(state & PERMIT_BIT)) {
+            return false;
+        }
+
+        if (m_state.compare_exchange_weak(state, state & ~PERMIT_BIT, acq_rel, acquire)) {
+            return true;
+        }
+    }
+}
+
+bool NotifyState::claimOrRegister(Notified* notified, Context& cx) {
+    if (this->tryClaim(notified->m_epoch)) {
         return true;
     }
 
-    waiters->add(cx.cloneWaker(), notified);
+    auto waiters = m_waiters.lock();
+    size_t state = m_state.load(acquire);
+
+    // the waiters bit must be set in the same atomic operation that verifies that nothing has changed,
+    // otherwise a concurrent notifyOne could store a permit or a notifyAll could skip locking the list
+    while (true) {
+        if ((state & EPOCH_MASK) != notified->m_epoch) {
+            return true;
+        }
+
+        if (state & PERMIT_BIT) {
+            if (m_state.compare_exchange_weak(state, state & ~PERMIT_BIT, acq_rel, acquire)) {
+                return true;
+            }
+
+            continue;
+        }
+
+        if (m_state.compare_exchange_weak(state, state | WAITERS_BIT, acq_rel, acquire)) {
+            break;
+        }
+    }
+
+    notified->m_waitState.store(Notified::State::Waiting, release);
+    waiters->add(*cx.waker(), notified);
     return false;
 }
 
 void NotifyState::unregister(Notified* notified) {
-    m_waiters.lock()->remove(notified);
+    auto waiters = m_waiters.lock();
+    waiters->remove(notified);
+
+    if (waiters->empty()) {
+        m_state.fetch_and(~WAITERS_BIT, release);
+    }
 }
 
+Notified::Notified(asp::SharedPtr<NotifyState> state) noexcept
+    : m_notify(std::move(state)), m_epoch(m_notify->epoch()) {}
+
 Notified::~Notified() {
-    this->reset();
+    if (m_notify && m_waitState.load(acquire) == State::Waiting) {
+        m_notify->unregister(this);
+    }
 }
 
 void Notified::reset() {
@@ -33,10 +87,12 @@ void Notified::reset() {
     }
 
     m_waitState.store(State::Init, release);
+    m_epoch = m_notify->epoch();
 }
 
 Notified::Notified(Notified&& other) noexcept {
     m_notify = std::move(other.m_notify);
+    m_epoch = other.m_epoch;
     auto state = other.m_waitState.load(acquire);
     m_waitState.store(state, release);
 
@@ -46,13 +102,8 @@ Notified::Notified(Notified&& other) noexcept {
 bool Notified::poll(Context& cx) {
     switch (m_waitState.load(acquire)) {
         case State::Init: {
-            // try to consume a stored permit and register otherwise
-            if (m_notify->claimStoredOrRegister(this, cx)) {
-                return true;
-            }
-
-            m_waitState.store(State::Waiting, release);
-            return false;
+            // check for a notifyAll or a stored permit, and register otherwise
+            return m_notify->claimOrRegister(this, cx);
         } break;
 
         case State::Waiting: {
@@ -72,20 +123,59 @@ Notified Notify::notified() const noexcept {
 }
 
 void Notify::notifyOne(bool store) const {
+    auto& state = m_state->m_state;
+    size_t current = state.load(acquire);
+
+    // fast path, nobody is waiting so just store the permit
+    while (!(current & NotifyState::WAITERS_BIT)) {
+        if (!store || (current & NotifyState::PERMIT_BIT)) {
+            return;
+        }
+
+        if (state.compare_exchange_weak(current, current | NotifyState::PERMIT_BIT, acq_rel, acquire)) {
+            return;
+        }
+    }
+
     auto waiters = m_state->m_waiters.lock();
 
     if (auto w = waiters->takeFirst()) {
+        if (waiters->empty()) {
+            state.fetch_and(~NotifyState::WAITERS_BIT, release);
+        }
+
         this->notify(w->waker, w->awaiter);
     } else if (store) {
-        m_state->m_storedPermit = true;
+        // the waiter unregistered itself in the meantime
+        state.fetch_or(NotifyState::PERMIT_BIT, acq_rel);
     }
 }
 
 void Notify::notifyAll() const {
+    size_t prev = m_state->m_state.fetch_add(NotifyState::EPOCH_ONE, acq_rel);
+
+    // any Notified that isn't registered yet will observe the new epoch on its own
+    if (!(prev & NotifyState::WAITERS_BIT)) {
+        return;
+    }
+
+    size_t newEpoch = (prev & NotifyState::EPOCH_MASK) + NotifyState::EPOCH_ONE;
+
     auto waiters = m_state->m_waiters.lock();
-    waiters->forAll([this](Waker& waker, Notified* awaiter) {
-        this->notify(waker, awaiter);
-    });
+
+    // only wake waiters that started waiting before the epoch advanced
+    waiters->takeIf(
+        [&](Notified* awaiter) {
+            return static_cast<ptrdiff_t>(newEpoch - awaiter->m_epoch) > 0;
+        },
+        [this](Waker& waker, Notified* awaiter) {
+            this->notify(waker, awaiter);
+        }
+    );
+
+    if (waiters->empty()) {
+        m_state->m_state.fetch_and(~NotifyState::WAITERS_BIT, release);
+    }
 }
 
 void Notify::notify(Waker& waker, Notified* waiter) const {
@@ -101,4 +191,4 @@ void Notify::notify(Waker& waker, Notified* waiter) const {
 
 Notify::Notify() : m_state(asp::make_shared<NotifyState>()) {}
 
-}
\ No newline at end of file
+}
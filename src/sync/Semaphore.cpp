@@ -7,7 +7,7 @@ namespace arc {
 
 using AcquireAwaiter = Semaphore::AcquireAwaiter;
 
-Semaphore::Semaphore(size_t permits) : m_permits(permits) {}
+Semaphore::Semaphore(size_t permits, Fairness fairness) : m_fairness(fairness), m_permits(permits) {}
 
 AcquireAwaiter Semaphore::acquire(size_t permits) noexcept {
     return AcquireAwaiter{*this, permits};
@@ -40,27 +40,45 @@ bool Semaphore::tryAcquire(size_t permits) noexcept {
     }
 }
 
-size_t Semaphore::tryAcquireOrRegister(size_t maxp, Context& cx, AcquireAwaiter* awaiter) {
+size_t Semaphore::tryAcquireOrRegister(size_t maxp, Context& cx, AcquireAwaiter* awaiter, bool front) {
     if (maxp == 0) return 0;
 
     auto waiters = m_waiters.lock();
 
-    size_t current = m_permits.load(::acquire);
+    size_t acquired = 0;
+    bool counted = false;
 
     while (true) {
-        if (current == 0) {
-            waiters->add(cx.cloneWaker(), awaiter);
-            return 0;
+        size_t current = m_permits.load(::seq_cst);
+        size_t toTake = std::min(current, maxp - acquired);
+
+        if (toTake > 0 && !m_permits.compare_exchange_weak(current, current - toTake, ::seq_cst, ::seq_cst)) {
+            continue;
         }
 
-        size_t toTake = std::min(current, maxp);
-        if (m_permits.compare_exchange_weak(current, current - toTake, ::acq_rel, ::acquire)) {
-            if (toTake < maxp) {
-                waiters->add(cx.cloneWaker(), awaiter);
-            }
+        acquired += toTake;
+
+        if (acquired == maxp) {
+            if (counted) m_waiting.fetch_sub(1, ::relaxed);
+            return acquired;
+        }
 
-            return toTake;
+        // announce ourselves before checking the permits one last time, this pairs with the check in release().
+        // either the releaser sees us and takes the slow path, or we see the permits it added
+        if (!counted) {
+            m_waiting.fetch_add(1, ::seq_cst);
+            counted = true;
+            continue;
         }
+
+        if (front) {
+            // a signalled waiter that lost the race keeps its place in the queue
+            waiters->addFront(*cx.waker(), awaiter);
+        } else {
+            waiters->add(*cx.waker(), awaiter);
+        }
+
+        return acquired;
     }
 }
 
@@ -84,16 +102,75 @@ void Semaphore::release() noexcept {
 void Semaphore::release(size_t n) noexcept {
     if (n == 0) return;
 
+    // fast path, nobody is waiting so the permits can go straight back without locking
+    if (m_waiting.load(::seq_cst) == 0) {
+        m_permits.fetch_add(n, ::seq_cst);
+
+        if (m_waiting.load(::seq_cst) == 0) {
+            return;
+        }
+
+        // a waiter registered concurrently and might have missed these permits, hand out what it needs
+        auto waiters = m_waiters.lock();
+        this->handOffAvailable(*waiters);
+        return;
+    }
+
     auto waiters = m_waiters.lock();
+    this->distribute(*waiters, n);
+}
+
+void Semaphore::distribute(WaitList<AcquireAwaiter>& waiters, size_t n) noexcept {
+    if (m_fairness == Fairness::Barging) {
+        this->signalWaiters(waiters, n);
+    } else {
+        this->assignPermits(waiters, n);
+    }
+}
+
+void Semaphore::signalWaiters(WaitList<AcquireAwaiter>& waiters, size_t n) noexcept {
+    if (n == 0) return;
+
+    // a waiter that was barged too many times gets a direct handoff, this bounds starvation
+    bool starving = false;
+    if (auto head = waiters.first()) {
+        auto lock = head->m_lock.lock();
+        starving = head->m_barged >= MAX_BARGES;
+    }
+
+    if (starving) {
+        this->assignPermits(waiters, n);
+        return;
+    }
+
+    m_permits.fetch_add(n, ::release);
+
+    // wake just enough waiters to consume the released permits, they will race with everyone else for them
+    size_t budget = n;
+    while (budget != 0) {
+        auto waiter = waiters.first();
+        if (!waiter) break;
+
+        {
+            auto lock = waiter->m_lock.lock();
+            waiter->m_woken = true;
+            budget -= std::min(budget, waiter->remaining());
+        }
 
+        m_waiting.fetch_sub(1, ::relaxed);
+        waiters.takeFirst()->waker.wake();
+    }
+}
+
+void Semaphore::assignPermits(WaitList<AcquireAwaiter>& waiters, size_t n) noexcept {
     while (n != 0) {
-        auto waiter = waiters->first();
+        auto waiter = waiters.first();
         if (!waiter) break;
 
-        if (this->assignPermitsTo(n, waiter->awaiter)) {
-            // the waiter got all the permits they need, wake and remove
-            waiter->waker.wake();
-            waiters->takeFirst();
+        if (this->assignPermitsTo(n, waiter)) {
+            // the waiter got all the permits they need, remove and wake
+            m_waiting.fetch_sub(1, ::relaxed);
+            waiters.takeFirst()->waker.wake();
         }
     }
 
@@ -103,6 +180,28 @@ void Semaphore::release(size_t n) noexcept {
     }
 }
 
+void Semaphore::handOffAvailable(WaitList<AcquireAwaiter>& waiters) noexcept {
+    size_t owed = 0;
+    waiters.forEach([&](AcquireAwaiter* waiter) {
+        auto lock = waiter->m_lock.lock();
+        owed += waiter->remaining();
+    });
+
+    size_t current = m_permits.load(::acquire);
+    size_t taken;
+
+    do {
+        taken = std::min(current, owed);
+        if (taken == 0) return;
+    } while (!m_permits.compare_exchange_weak(current, current - taken, ::acq_rel, ::acquire));
+
+    this->distribute(waiters, taken);
+}
+
+bool Semaphore::hasWaiters() const noexcept {
+    return m_waiting.load(::seq_cst) != 0;
+}
+
 size_t Semaphore::permits() const noexcept {
     return m_permits.load(::acquire);
 }
@@ -115,6 +214,10 @@ bool AcquireAwaiter::poll(Context& cx) {
     auto guard = m_lock.lock();
 
     if (m_acquired == 0 && !m_registered) {
+        if (!cx.pollBudget()) {
+            return false;
+        }
+
         // handle initial state, try to acquire fast and then register if failed
         m_acquired = m_sem.tryAcquireOrRegister(m_requested, cx, this);
 
@@ -127,7 +230,21 @@ bool AcquireAwaiter::poll(Context& cx) {
         m_registered = true;
         return false;
     } else if (m_acquired < m_requested && m_registered) {
-        // handle waiting state, not much to do here other than waiting
+        // handle waiting state, not much to do here other than waiting, unless a barging release signalled us
+        if (!m_woken) {
+            return false;
+        }
+
+        m_woken = false;
+        m_acquired += m_sem.tryAcquireOrRegister(this->remaining(), cx, this, true);
+
+        if (m_acquired == m_requested) {
+            m_acquired = 0;
+            return true;
+        }
+
+        // somebody else got there first
+        if (m_barged < MAX_BARGES) m_barged++;
         return false;
     } else if (m_acquired >= m_requested) {
         // completed!
@@ -154,12 +271,20 @@ AcquireAwaiter::AcquireAwaiter(AcquireAwaiter&& other) noexcept
 
 AcquireAwaiter::~AcquireAwaiter() {
     if (m_registered) {
-        m_sem.m_waiters.lock()->remove(this);
+        if (m_sem.m_waiters.lock()->remove(this)) {
+            m_sem.m_waiting.fetch_sub(1, ::relaxed);
+        }
     }
 
     if (m_acquired > 0) {
         m_sem.release(m_acquired);
     }
+
+    // we were signalled but never came back for the permits, pass the signal on to the next waiter
+    if (m_woken) {
+        auto waiters = m_sem.m_waiters.lock();
+        m_sem.handOffAvailable(*waiters);
+    }
 }
 
 }
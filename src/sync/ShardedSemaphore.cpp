@@ -0,0 +1,144 @@
+#include <arc/sync/ShardedSemaphore.hpp>
+#include <algorithm>
+#include <thread>
+
+using enum std::memory_order;
+
+static std::atomic<size_t> g_nextThreadIndex{0};
+static thread_local size_t t_threadIndex = g_nextThreadIndex.fetch_add(1, relaxed);
+
+namespace arc {
+
+using AcquireAwaiter = ShardedSemaphore::AcquireAwaiter;
+
+ShardedSemaphore::ShardedSemaphore(size_t permits, size_t batch)
+    : m_global(permits),
+      m_batch(std::max<size_t>(batch, 1)),
+      m_shardCount(std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 64)),
+      m_shards(std::make_unique<Shard[]>(m_shardCount)) {}
+
+AcquireAwaiter ShardedSemaphore::acquire(size_t permits) noexcept {
+    return AcquireAwaiter{*this, permits};
+}
+
+bool ShardedSemaphore::tryAcquire(size_t permits) noexcept {
+    auto& shard = this->localShard();
+
+    // fast path, take from the local cache
+    size_t cached = shard.cached.load(::relaxed);
+    while (cached >= permits) {
+        if (shard.cached.compare_exchange_weak(cached, cached - permits, ::acquire, ::relaxed)) {
+            return true;
+        }
+    }
+
+    // refill the cache along the way if the global pool has enough
+    if (m_global.tryAcquire(permits + m_batch)) {
+        shard.cached.fetch_add(m_batch, ::release);
+        return true;
+    }
+
+    if (m_global.tryAcquire(permits)) {
+        return true;
+    }
+
+    // last resort, combine the local cache with whatever the global pool has
+    size_t local = shard.cached.exchange(0, ::acquire);
+    if (local >= permits) {
+        // another thread on this shard released in the meantime
+        this->release(local - permits);
+        return true;
+    }
+
+    if (local != 0 && m_global.tryAcquire(permits - local)) {
+        return true;
+    }
+
+    if (local != 0) {
+        this->release(local);
+    }
+
+    return false;
+}
+
+void ShardedSemaphore::release(size_t permits) noexcept {
+    if (permits == 0) return;
+
+    // waiters are served by the global semaphore, don't hide permits from them
+    if (m_global.hasWaiters()) {
+        m_global.release(permits);
+        return;
+    }
+
+    auto& shard = this->localShard();
+    size_t cached = shard.cached.fetch_add(permits, ::seq_cst) + permits;
+
+    // spill everything above one batch back into the global pool
+    if (cached > 2 * m_batch) {
+        while (cached > m_batch) {
+            if (shard.cached.compare_exchange_weak(cached, m_batch, ::acq_rel, ::relaxed)) {
+                m_global.release(cached - m_batch);
+                break;
+            }
+        }
+    }
+
+    // a task may have started waiting right after our check, it flushes every shard after registering.
+    // either it sees the permits we just cached, or we see it here
+    if (m_global.hasWaiters()) {
+        this->flushShard(shard);
+    }
+}
+
+size_t ShardedSemaphore::permits() const noexcept {
+    size_t total = m_global.permits();
+
+    for (size_t i = 0; i < m_shardCount; i++) {
+        total += m_shards[i].cached.load(::relaxed);
+    }
+
+    return total;
+}
+
+ShardedSemaphore::Shard& ShardedSemaphore::localShard() const noexcept {
+    return m_shards[t_threadIndex % m_shardCount];
+}
+
+void ShardedSemaphore::flushShard(Shard& shard) noexcept {
+    size_t cached = shard.cached.exchange(0, ::seq_cst);
+    if (cached) {
+        m_global.release(cached);
+    }
+}
+
+void ShardedSemaphore::flushAll() noexcept {
+    for (size_t i = 0; i < m_shardCount; i++) {
+        this->flushShard(m_shards[i]);
+    }
+}
+
+bool AcquireAwaiter::poll(Context& cx) {
+    if (m_slow) {
+        return m_slow->poll(cx);
+    }
+
+    if (!cx.pollBudget()) {
+        return false;
+    }
+
+    if (m_sem->tryAcquire(m_permits)) {
+        return true;
+    }
+
+    // not enough permits locally or globally, wait on the global semaphore
+    m_slow.emplace(m_sem->m_global.acquire(m_permits));
+    if (m_slow->poll(cx)) {
+        return true;
+    }
+
+    // now that we are registered as a waiter, pull in the permits that are sitting in other shards
+    m_sem->flushAll();
+    return m_slow->poll(cx);
+}
+
+}
@@ -0,0 +1,56 @@
+#include <arc/task/AtomicWaker.hpp>
+#include <arc/future/Context.hpp>
+
+using enum std::memory_order;
+
+namespace arc {
+
+void AtomicWaker::registerWaker(const Waker& waker) noexcept {
+    uint8_t state = WAITING;
+
+    if (m_state.compare_exchange_strong(state, REGISTERING, acquire, acquire)) {
+        // we now have exclusive access to the stored waker
+        if (!m_waker || !m_waker.equals(waker)) {
+            m_waker = waker.clone();
+        }
+
+        // release the lock, if this fails then a wake happened while we were registering
+        state = REGISTERING;
+        if (!m_state.compare_exchange_strong(state, WAITING, acq_rel, acquire)) {
+            // the only possible state here is REGISTERING | WAKING, the waker must be taken and woken by us
+            Waker taken = std::move(m_waker);
+            m_state.exchange(WAITING, acq_rel);
+            taken.wake();
+        }
+    } else if (state == WAKING) {
+        // currently being woken up, so wake the given waker directly as the waking thread may have missed it
+        waker.clone().wake();
+    } else {
+        // concurrent registration, this is a misuse of AtomicWaker and is ignored
+    }
+}
+
+void AtomicWaker::registerWaker(Context& cx) noexcept {
+    if (auto waker = cx.waker()) {
+        this->registerWaker(*waker);
+    }
+}
+
+void AtomicWaker::wake() noexcept {
+    if (auto waker = this->take()) {
+        waker.wake();
+    }
+}
+
+Waker AtomicWaker::take() noexcept {
+    if (m_state.fetch_or(WAKING, acq_rel) == WAITING) {
+        Waker waker = std::move(m_waker);
+        m_state.fetch_and(static_cast<uint8_t>(~WAKING), release);
+        return waker;
+    }
+
+    // a registration is in progress and will wake the waker itself, or another thread is already waking
+    return Waker{};
+}
+
+}
@@ -0,0 +1,69 @@
+#include <arc/task/CancellationToken.hpp>
+
+using enum std::memory_order;
+
+namespace arc {
+
+CancellationState::CancellationState(asp::SharedPtr<CancellationState> parent) noexcept {
+    auto head = parent->m_firstChild.lock();
+
+    // checked under the lock, so the parent either sees this node during its traversal or we see the flag here
+    if (parent->isCancelled()) {
+        m_cancelled.store(true, release);
+        return;
+    }
+
+    m_nextSibling = *head;
+    if (m_nextSibling) {
+        m_nextSibling->m_prevSibling = this;
+    }
+    *head = this;
+
+    m_parent = std::move(parent);
+}
+
+CancellationState::~CancellationState() {
+    if (!m_parent) {
+        return;
+    }
+
+    // a concurrent cancel of the parent may be walking the list right now, it holds the lock until it's done with us
+    auto head = m_parent->m_firstChild.lock();
+
+    if (m_prevSibling) {
+        m_prevSibling->m_nextSibling = m_nextSibling;
+    } else {
+        *head = m_nextSibling;
+    }
+
+    if (m_nextSibling) {
+        m_nextSibling->m_prevSibling = m_prevSibling;
+    }
+}
+
+bool CancellationState::isCancelled() const noexcept {
+    return m_cancelled.load(acquire);
+}
+
+void CancellationState::cancel() noexcept {
+    if (m_cancelled.exchange(true, acq_rel)) {
+        return;
+    }
+
+    m_notify.notifyAll();
+
+    // children stay linked, they unlink themselves on destruction.
+    // locks are always taken parent first, so recursing while holding our lock cannot deadlock
+    auto head = m_firstChild.lock();
+    for (auto child = *head; child; child = child->m_nextSibling) {
+        child->cancel();
+    }
+}
+
+CancellationToken::CancellationToken() : m_state(asp::make_shared<CancellationState>()) {}
+
+CancellationToken CancellationToken::child() const {
+    return CancellationToken{asp::make_shared<CancellationState>(m_state)};
+}
+
+}
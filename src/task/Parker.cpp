@@ -0,0 +1,114 @@
+#include <arc/task/Parker.hpp>
+#include <asp/time/chrono.hpp>
+#include <algorithm>
+
+#ifdef __linux__
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# include <time.h>
+#elif defined(_WIN32)
+# include <Windows.h>
+#endif
+
+using namespace asp::time;
+using enum std::memory_order;
+
+namespace arc {
+
+void Parker::park() noexcept {
+    // EMPTY -> PARKED or NOTIFIED -> EMPTY
+    if (m_state.fetch_sub(1, ::acquire) == NOTIFIED) {
+        return;
+    }
+
+    while (true) {
+        this->wait(nullptr);
+
+        int32_t expected = NOTIFIED;
+        if (m_state.compare_exchange_strong(expected, EMPTY, ::acquire, ::acquire)) {
+            return;
+        }
+
+        // spurious wakeup, go back to sleep
+    }
+}
+
+bool Parker::parkTimeout(Duration timeout) noexcept {
+    if (m_state.fetch_sub(1, ::acquire) == NOTIFIED) {
+        return true;
+    }
+
+    this->wait(&timeout);
+
+    // either unparked, timed out or woke up spuriously. reset the state in any case
+    return m_state.exchange(EMPTY, ::acquire) == NOTIFIED;
+}
+
+void Parker::unpark() noexcept {
+    if (m_state.exchange(NOTIFIED, ::release) == PARKED) {
+        this->wake();
+    }
+}
+
+#ifdef __linux__
+
+void Parker::wait(const Duration* timeout) noexcept {
+    struct timespec ts;
+    struct timespec* tsp = nullptr;
+
+    if (timeout) {
+        uint64_t nanos = timeout->nanos();
+        ts.tv_sec = nanos / 1'000'000'000;
+        ts.tv_nsec = nanos % 1'000'000'000;
+        tsp = &ts;
+    }
+
+    syscall(SYS_futex, &m_state, FUTEX_WAIT_PRIVATE, PARKED, tsp, nullptr, 0);
+}
+
+void Parker::wake() noexcept {
+    syscall(SYS_futex, &m_state, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+#elif defined(_WIN32)
+
+void Parker::wait(const Duration* timeout) noexcept {
+    int32_t expected = PARKED;
+    DWORD millis = INFINITE;
+
+    if (timeout) {
+        // round up, so that short timeouts don't turn into busy loops
+        millis = static_cast<DWORD>(std::min<uint64_t>((timeout->micros() + 999) / 1000, INFINITE - 1));
+    }
+
+    WaitOnAddress(&m_state, &expected, sizeof(expected), millis);
+}
+
+void Parker::wake() noexcept {
+    WakeByAddressSingle(&m_state);
+}
+
+#else
+
+void Parker::wait(const Duration* timeout) noexcept {
+    std::unique_lock lock(m_mtx);
+
+    auto pred = [this] { return m_state.load(::acquire) != PARKED; };
+
+    if (timeout) {
+        m_cv.wait_for(lock, asp::toChrono(*timeout), pred);
+    } else {
+        m_cv.wait(lock, pred);
+    }
+}
+
+void Parker::wake() noexcept {
+    // lock the mutex so the notification can't slip in between the predicate check and the wait
+    { std::lock_guard lock(m_mtx); }
+    m_cv.notify_one();
+}
+
+#endif
+
+}
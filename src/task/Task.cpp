@@ -33,20 +33,64 @@ std::vector<void*> TaskDebugData::creationStack() const noexcept {
     return stack;
 }
 
+TaskBase::~TaskBase() {
+    delete m_cold.load(std::memory_order::acquire);
+}
+
+TaskColdData* TaskBase::coldData() const noexcept {
+    return m_cold.load(std::memory_order::acquire);
+}
+
+TaskColdData& TaskBase::ensureColdData() {
+    if (auto cold = this->coldData()) {
+        return *cold;
+    }
+
+    // two threads may race here, e.g. a handle setting the name while the task is first awaited
+    auto cold = new TaskColdData;
+    TaskColdData* expected = nullptr;
+    if (!m_cold.compare_exchange_strong(expected, cold, std::memory_order::acq_rel, std::memory_order::acquire)) {
+        delete cold;
+        return *expected;
+    }
+
+    return *cold;
+}
+
 void TaskBase::schedule() {
+#ifdef ARC_STATIC_DISPATCH
+    TaskBase::vSchedule(this);
+#else
     m_vtable->schedule(this);
+#endif
 }
 
 void TaskBase::abort() noexcept {
+#ifdef ARC_STATIC_DISPATCH
+    TaskBase::vAbort(this, false);
+#else
     m_vtable->abort(this, false);
+#endif
 }
 
 void TaskBase::setName(asp::BoxedString name) noexcept {
+#ifdef ARC_STATIC_DISPATCH
+    TaskBase::vSetName(this, std::move(name));
+#else
     m_vtable->setName(this, std::move(name));
+#endif
 }
 
 asp::SharedPtr<TaskDebugData> TaskBase::getDebugData() noexcept {
+#ifdef ARC_STATIC_DISPATCH
+    return TaskBase::vGetDebugData(this);
+#else
     return m_vtable->getDebugData(this);
+#endif
+}
+
+void TaskBase::setCoopBudget(uint32_t budget) noexcept {
+    m_coopBudget.store(budget, std::memory_order::relaxed);
 }
 
 std::optional<bool> TaskBase::vPoll(void* ptr, Context& cx) {
@@ -154,7 +198,7 @@ void TaskBase::vSchedule(void* self) {
 
     if ((state & TASK_ABANDONED) == 0) {
         auto rt = task->m_runtime;
-        if (rt && !rt->isShuttingDown()) {
+        if (rt && !rt->isShuttingDown() && !WakeBatch::tryPush(rt, task)) {
             rt->enqueueTask(task);
         }
     }
@@ -217,20 +261,27 @@ bool TaskBase::exchangeState(uint64_t& expected, uint64_t newState) noexcept {
 }
 
 void TaskBase::ensureDebugData() {
-    if (!m_debugData) {
-        m_debugData = asp::make_shared<TaskDebugData>();
-        m_debugData->m_task = this;
+    auto& cold = this->ensureColdData();
+
+    if (!cold.debugData) {
+        cold.debugData = asp::make_shared<TaskDebugData>();
+        cold.debugData->m_task = this;
+        *cold.debugData->m_name.lock() = cold.name;
 
 #ifdef ARC_HAS_STACKTRACE
         for (auto& frame : std::stacktrace::current(1)) {
-            m_debugData->m_creationStack.push_back(frame.native_handle());
+            cold.debugData->m_creationStack.push_back(frame.native_handle());
         }
 #endif
     }
 }
 
 std::string TaskBase::debugName() {
+#ifdef ARC_STATIC_DISPATCH
+    auto n = TaskBase::vGetName(this);
+#else
     auto n = this->m_vtable->getName(this);
+#endif
     if (n.empty()) {
         return fmt::format("Task @ {}", (void*)this);
     }
@@ -242,7 +293,11 @@ Waker TaskBase::takeAwaiter(const Waker* current) {
 
     Waker out;
     if ((state & (TASK_NOTIFYING | TASK_REGISTERING)) == 0) {
-        out = std::move(this->m_awaiter);
+        // the cold block is always allocated before an awaiter is registered
+        if (auto cold = this->coldData()) {
+            out = std::move(cold->awaiter);
+        }
+
         this->m_state.fetch_and(~TASK_NOTIFYING & ~TASK_AWAITER, std::memory_order::release);
 
         if (current && out.equals(*current)) {
@@ -255,23 +310,27 @@ Waker TaskBase::takeAwaiter(const Waker* current) {
 
 void TaskBase::vSetName(void* ptr, asp::BoxedString name) noexcept {
     auto self = static_cast<TaskBase*>(ptr);
-    self->m_name = std::move(name);
-    if (self->m_debugData) {
-        *self->m_debugData->m_name.lock() = self->m_name;
+    auto& cold = self->ensureColdData();
+    cold.name = std::move(name);
+    if (cold.debugData) {
+        *cold.debugData->m_name.lock() = cold.name;
     }
 }
 
 asp::BoxedString TaskBase::vGetName(void* ptr) noexcept {
     auto self = static_cast<TaskBase*>(ptr);
-    return self->m_name;
+    auto cold = self->coldData();
+    return cold ? cold->name : asp::BoxedString{};
 }
 
 asp::SharedPtr<TaskDebugData> TaskBase::vGetDebugData(void* ptr) {
     auto self = static_cast<TaskBase*>(ptr);
-    return self->m_debugData;
+    auto cold = self->coldData();
+    return cold ? cold->debugData : nullptr;
 }
 
 void TaskBase::registerAwaiter(Waker& waker) {
+    auto& cold = this->ensureColdData();
     auto state = this->m_state.fetch_or(0, std::memory_order::acquire);
     ARC_TRACE("[{}] registering waker {} (state: {})", this->debugName(), waker.m_data, state);
 
@@ -291,14 +350,14 @@ void TaskBase::registerAwaiter(Waker& waker) {
     }
 
     // store the awaiter
-    this->m_awaiter = waker.clone();
+    cold.awaiter = waker.clone();
 
     Waker w;
 
     while (true) {
         // if there was a notification, take out the awaiter
         if (state & TASK_NOTIFYING) {
-            w = std::move(this->m_awaiter);
+            w = std::move(cold.awaiter);
         }
 
         // the new state is not being notified nor registering, but there might be an awaiter
@@ -321,7 +380,7 @@ void TaskBase::registerAwaiter(Waker& waker) {
 }
 
 void TaskBase::notifyAwaiter(Waker* current) {
-    ARC_TRACE("[{}] notifying waker {} (cur: {})", this->debugName(), this->m_awaiter ? this->m_awaiter.m_data : nullptr, current->m_data);
+    ARC_TRACE("[{}] notifying waker (cur: {})", this->debugName(), current ? current->m_data : nullptr);
 
     auto w = this->takeAwaiter(current);
 
@@ -0,0 +1,103 @@
+#include <arc/task/TaskRegistry.hpp>
+#include <arc/task/Task.hpp>
+#include <atomic>
+#include <bit>
+
+namespace arc {
+
+static constexpr uint32_t DETACHED_SHARD = UINT32_MAX;
+
+TaskRegistry::TaskRegistry(size_t shards)
+    : m_shardCount(std::bit_ceil(std::max<size_t>(shards, 1))),
+      m_shards(std::make_unique<Shard[]>(m_shardCount)) {}
+
+TaskRegistry::~TaskRegistry() = default;
+
+uint32_t TaskRegistry::currentShard() const noexcept {
+    // every thread sticks to one shard, so spawns from the same worker never contend with each other
+    static std::atomic<uint32_t> nextIndex{0};
+    static thread_local uint32_t index = nextIndex.fetch_add(1, std::memory_order::relaxed);
+
+    return index & (m_shardCount - 1);
+}
+
+void TaskRegistry::insert(TaskBase* task) noexcept {
+    uint32_t idx = this->currentShard();
+    auto shard = m_shards[idx].data.lock();
+
+    task->m_registryShard.store(idx, std::memory_order::relaxed);
+    task->m_registryPrev = nullptr;
+    task->m_registryNext = shard->head;
+    if (shard->head) {
+        shard->head->m_registryPrev = task;
+    }
+
+    shard->head = task;
+    shard->count++;
+}
+
+void TaskRegistry::remove(TaskBase* task) noexcept {
+    // the shard index only ever changes from a valid index to detached, and that happens under the shard lock
+    uint32_t idx = task->m_registryShard.load(std::memory_order::relaxed);
+    if (idx == DETACHED_SHARD) {
+        return;
+    }
+
+    auto shard = m_shards[idx].data.lock();
+    if (task->m_registryShard.load(std::memory_order::relaxed) == DETACHED_SHARD) {
+        return;
+    }
+
+    if (task->m_registryPrev) {
+        task->m_registryPrev->m_registryNext = task->m_registryNext;
+    } else {
+        shard->head = task->m_registryNext;
+    }
+
+    if (task->m_registryNext) {
+        task->m_registryNext->m_registryPrev = task->m_registryPrev;
+    }
+
+    task->m_registryPrev = task->m_registryNext = nullptr;
+    task->m_registryShard.store(DETACHED_SHARD, std::memory_order::relaxed);
+    shard->count--;
+}
+
+size_t TaskRegistry::size() const noexcept {
+    size_t total = 0;
+    for (size_t i = 0; i < m_shardCount; i++) {
+        total += m_shards[i].data.lock()->count;
+    }
+    return total;
+}
+
+TaskBase* TaskRegistry::takeAll() noexcept {
+    TaskBase* chain = nullptr;
+
+    for (size_t i = 0; i < m_shardCount; i++) {
+        auto shard = m_shards[i].data.lock();
+
+        TaskBase* task = shard->head;
+        while (task) {
+            auto next = task->m_registryNext;
+
+            task->m_registryShard.store(DETACHED_SHARD, std::memory_order::relaxed);
+            task->m_registryPrev = nullptr;
+            task->m_registryNext = chain;
+            chain = task;
+
+            task = next;
+        }
+
+        shard->head = nullptr;
+        shard->count = 0;
+    }
+
+    return chain;
+}
+
+TaskBase* TaskRegistry::nextOf(TaskBase* task) noexcept {
+    return task->m_registryNext;
+}
+
+}
@@ -7,7 +7,7 @@ using namespace asp::time;
 namespace arc {
 
 bool Sleep::poll(Context& cx) noexcept {
-    if (cx.shouldCoopYield()) {
+    if (!cx.pollBudget()) {
         return false;
     }
 
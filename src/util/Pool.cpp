@@ -0,0 +1,224 @@
+#include <arc/util/Pool.hpp>
+#include <atomic>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+using enum std::memory_order;
+
+namespace arc::pool {
+
+static constexpr size_t MIN_CLASS_SHIFT = 6; // 64 bytes
+static constexpr size_t CLASS_COUNT = std::bit_width(MAX_POOLED_SIZE) - MIN_CLASS_SHIFT;
+static constexpr uint32_t UNPOOLED = UINT32_MAX;
+
+// upper bound on the memory cached by a single free list, so a burst of allocations does not pin memory forever
+static constexpr size_t MAX_CACHED_BYTES = 256 * 1024;
+
+struct ThreadCache;
+
+struct alignas(alignof(std::max_align_t)) BlockHeader {
+    ThreadCache* owner;
+    uint32_t sizeClass;
+};
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+static size_t classSize(size_t cls) noexcept {
+    return size_t(1) << (cls + MIN_CLASS_SHIFT);
+}
+
+static size_t classFor(size_t size) noexcept {
+    if (size <= classSize(0)) return 0;
+    return std::bit_width(size - 1) - MIN_CLASS_SHIFT;
+}
+
+static BlockHeader* headerOf(void* ptr) noexcept {
+    return static_cast<BlockHeader*>(ptr) - 1;
+}
+
+static FreeBlock* blockOf(BlockHeader* header) noexcept {
+    return reinterpret_cast<FreeBlock*>(header + 1);
+}
+
+static void freeChain(FreeBlock* block) noexcept {
+    while (block) {
+        auto next = block->next;
+        ::operator delete(headerOf(block));
+        block = next;
+    }
+}
+
+/// Per-thread pool. It is heap allocated, because blocks can outlive the thread that allocated them:
+/// once the thread exits, the cache is abandoned and deleted when the last outstanding block is freed.
+struct ThreadCache {
+    struct SizeClass {
+        FreeBlock* local = nullptr;
+        size_t localCount = 0;
+        // blocks freed by other threads, the owner takes the whole stack at once so there is no ABA problem
+        std::atomic<FreeBlock*> remote{nullptr};
+    };
+
+    std::array<SizeClass, CLASS_COUNT> classes;
+    Stats stats; // only touched by the owning thread
+
+    // blocks handed out and not yet returned, plus one reference held by the exiting thread
+    std::atomic<size_t> live{0};
+    std::atomic<bool> abandoned{false};
+
+    void* allocate(size_t cls) {
+        auto& sc = classes[cls];
+
+        if (!sc.local && sc.remote.load(relaxed)) {
+            // reclaim everything other threads have freed in the meantime
+            sc.local = sc.remote.exchange(nullptr, acquire);
+            sc.localCount = 0;
+            for (auto b = sc.local; b; b = b->next) sc.localCount++;
+        }
+
+        live.fetch_add(1, relaxed);
+
+        if (auto block = sc.local) {
+            sc.local = block->next;
+            sc.localCount--;
+            stats.hits++;
+            return block;
+        }
+
+        stats.misses++;
+        auto header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + classSize(cls)));
+        header->owner = this;
+        header->sizeClass = static_cast<uint32_t>(cls);
+        return blockOf(header);
+    }
+
+    /// Called on the owning thread
+    void freeLocal(FreeBlock* block, size_t cls) noexcept {
+        auto& sc = classes[cls];
+
+        if (sc.localCount * classSize(cls) >= MAX_CACHED_BYTES) {
+            ::operator delete(headerOf(block));
+        } else {
+            block->next = sc.local;
+            sc.local = block;
+            sc.localCount++;
+        }
+
+        live.fetch_sub(1, relaxed);
+    }
+
+    /// Called on any other thread
+    void freeRemote(FreeBlock* block, size_t cls) noexcept {
+        auto& sc = classes[cls];
+
+        FreeBlock* head = sc.remote.load(relaxed);
+        do {
+            block->next = head;
+        } while (!sc.remote.compare_exchange_weak(head, block, seq_cst, relaxed));
+
+        // if the owner already exited, it might not drain this stack anymore, so do it ourselves
+        if (abandoned.load(seq_cst)) {
+            freeChain(sc.remote.exchange(nullptr, acquire));
+        }
+
+        this->release();
+    }
+
+    void release() noexcept {
+        if (live.fetch_sub(1, acq_rel) == 1 && abandoned.load(acquire)) {
+            delete this;
+        }
+    }
+
+    void threadExit() noexcept {
+        live.fetch_add(1, relaxed);
+        abandoned.store(true, seq_cst);
+
+        for (auto& sc : classes) {
+            freeChain(sc.local);
+            freeChain(sc.remote.exchange(nullptr, seq_cst));
+            sc.local = nullptr;
+            sc.localCount = 0;
+        }
+
+        this->release();
+    }
+};
+
+static thread_local ThreadCache* t_cache = nullptr;
+
+struct ThreadCacheHolder {
+    ThreadCacheHolder() : cache(new ThreadCache) {
+        t_cache = cache;
+    }
+
+    ~ThreadCacheHolder() {
+        t_cache = nullptr;
+        cache->threadExit();
+    }
+
+    ThreadCache* cache;
+};
+
+static ThreadCache* currentCache() noexcept {
+    if (t_cache) [[likely]] {
+        return t_cache;
+    }
+
+    // the holder is only constructed once, after the thread exits t_cache stays null and allocations are unpooled
+    static thread_local bool initialized = false;
+    if (initialized) {
+        return nullptr;
+    }
+
+    initialized = true;
+    static thread_local ThreadCacheHolder holder;
+    return holder.cache;
+}
+
+void* allocate(size_t size) {
+    auto cache = currentCache();
+
+    if (cache && size <= MAX_POOLED_SIZE) {
+        return cache->allocate(classFor(size));
+    } else if (cache) {
+        cache->stats.misses++;
+    }
+
+    auto header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+    header->owner = nullptr;
+    header->sizeClass = UNPOOLED;
+    return header + 1;
+}
+
+void deallocate(void* ptr) noexcept {
+    if (!ptr) return;
+
+    auto header = headerOf(ptr);
+    auto owner = header->owner;
+
+    if (!owner) {
+        ::operator delete(header);
+        return;
+    }
+
+    auto block = static_cast<FreeBlock*>(ptr);
+
+    if (owner == t_cache) {
+        owner->freeLocal(block, header->sizeClass);
+    } else {
+        owner->freeRemote(block, header->sizeClass);
+    }
+}
+
+Stats threadStats() noexcept {
+    if (auto cache = currentCache()) {
+        return cache->stats;
+    }
+
+    return {};
+}
+
+}
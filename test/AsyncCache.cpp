@@ -0,0 +1,120 @@
+#include <arc/sync/AsyncCache.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <arc/task/Yield.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace arc;
+using namespace asp::time;
+
+TEST(AsyncCache, CoalescesLookups) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    AsyncCache<int, std::string> cache{64, Duration::fromSecs(60)};
+    Notify notify;
+    size_t calls = 0;
+
+    auto fetch = [&](const int& key) -> Future<std::string> {
+        calls++;
+        co_await notify.notified();
+        co_return std::to_string(key);
+    };
+
+    auto a = cache.getOrFetch(1, fetch);
+    auto b = cache.getOrFetch(1, fetch);
+    auto c = cache.getOrFetch(2, fetch);
+
+    EXPECT_FALSE(a.poll(cx));
+    EXPECT_FALSE(b.poll(cx));
+    EXPECT_FALSE(c.poll(cx));
+    EXPECT_EQ(calls, 2);
+
+    notify.notifyAll();
+
+    EXPECT_EQ(a.poll(cx), "1");
+    EXPECT_EQ(b.poll(cx), "1");
+    EXPECT_EQ(c.poll(cx), "2");
+
+    // cached now, the fetch function is not called again
+    EXPECT_EQ(cache.getOrFetch(1, fetch).poll(cx), "1");
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(AsyncCache, Expiry) {
+    AsyncCache<int, int> cache{64, Duration::fromMillis(10)};
+
+    cache.insert(1, 100);
+    EXPECT_EQ(cache.get(1), 100);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(cache.get(1), std::nullopt);
+}
+
+TEST(AsyncCache, Eviction) {
+    AsyncCache<int, int> cache{4, Duration::fromSecs(60), 1};
+
+    for (int i = 0; i < 10; i++) {
+        cache.insert(i, i);
+    }
+
+    EXPECT_EQ(cache.size(), 4);
+
+    // oldest entries are evicted first
+    EXPECT_EQ(cache.get(0), std::nullopt);
+    EXPECT_EQ(cache.get(9), 9);
+
+    cache.invalidate(9);
+    EXPECT_EQ(cache.get(9), std::nullopt);
+    EXPECT_EQ(cache.size(), 3);
+}
+
+TEST(AsyncCache, AbandonedFetch) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    AsyncCache<int, int> cache{64, Duration::fromSecs(60)};
+    Notify notify;
+
+    auto b = cache.getOrFetch(1, [](const int&) -> Future<int> { co_return 2; });
+
+    {
+        auto a = cache.getOrFetch(1, [&](const int&) -> Future<int> {
+            co_await notify.notified();
+            co_return 1;
+        });
+
+        EXPECT_FALSE(a.poll(cx));
+        EXPECT_FALSE(b.poll(cx));
+    }
+
+    // the leader was dropped, so the follower runs its own fetch
+    EXPECT_EQ(b.poll(cx), 2);
+    EXPECT_EQ(cache.get(1), 2);
+}
+
+TEST(AsyncCache, Concurrent) {
+    auto rt = Runtime::create(4);
+    AsyncCache<int, int> cache{64, Duration::fromSecs(60)};
+    std::atomic<size_t> calls{0};
+
+    std::vector<TaskHandle<void>> handles;
+    for (size_t i = 0; i < 32; i++) {
+        handles.push_back(rt->spawn([&, i] -> Future<> {
+            int key = i % 4;
+            int value = co_await cache.getOrFetch(key, [&](const int& k) -> Future<int> {
+                calls.fetch_add(1);
+                co_await yield();
+                co_return k * 10;
+            });
+            EXPECT_EQ(value, key * 10);
+        }));
+    }
+
+    for (auto& h : handles) {
+        h.blockOn();
+    }
+
+    EXPECT_EQ(calls.load(), 4);
+}
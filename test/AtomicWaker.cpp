@@ -0,0 +1,76 @@
+#include <arc/task/AtomicWaker.hpp>
+#include <arc/future/Context.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace arc;
+
+namespace {
+struct CountingWaker {
+    std::atomic<size_t> wakes{0};
+
+    Waker waker() noexcept {
+        static constexpr RawWakerVtable vtable = {
+            .wake = [](void* data) {
+                static_cast<CountingWaker*>(data)->wakes.fetch_add(1);
+            },
+            .wakeByRef = [](void* data) {
+                static_cast<CountingWaker*>(data)->wakes.fetch_add(1);
+            },
+            .clone = [](void* data) -> RawWaker {
+                return RawWaker{data, &vtable};
+            },
+            .destroy = [](void*) {},
+        };
+
+        return Waker{this, &vtable};
+    }
+};
+}
+
+TEST(AtomicWaker, RegisterAndWake) {
+    CountingWaker counter;
+    AtomicWaker aw;
+
+    // waking without a registered waker does nothing
+    aw.wake();
+
+    auto waker = counter.waker();
+    aw.registerWaker(waker);
+    aw.wake();
+    EXPECT_EQ(counter.wakes.load(), 1);
+
+    // the waker is consumed by wake
+    aw.wake();
+    EXPECT_EQ(counter.wakes.load(), 1);
+
+    Context cx { &waker };
+    aw.registerWaker(cx);
+    EXPECT_TRUE(aw.take());
+    EXPECT_FALSE(aw.take());
+    EXPECT_EQ(counter.wakes.load(), 1);
+}
+
+TEST(AtomicWaker, ConcurrentWake) {
+    CountingWaker counter;
+    AtomicWaker aw;
+    std::atomic<bool> flag{false};
+
+    auto waker = counter.waker();
+    aw.registerWaker(waker);
+
+    std::thread t([&] {
+        flag.store(true, std::memory_order::release);
+        aw.wake();
+    });
+
+    // the waiting side registers and re-checks the condition, like a pollable would
+    while (true) {
+        aw.registerWaker(waker);
+        if (flag.load(std::memory_order::acquire)) break;
+        std::this_thread::yield();
+    }
+
+    t.join();
+    EXPECT_GE(counter.wakes.load(), 1);
+}
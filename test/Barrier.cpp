@@ -0,0 +1,122 @@
+#include <arc/sync/Barrier.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+using namespace arc;
+
+TEST(Barrier, ReleasesAll) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Barrier barrier{3};
+    auto w1 = barrier.wait();
+    auto w2 = barrier.wait();
+    auto w3 = barrier.wait();
+
+    EXPECT_FALSE(w1.poll(cx));
+    EXPECT_FALSE(w2.poll(cx));
+
+    auto r3 = w3.poll(cx);
+    ASSERT_TRUE(r3);
+    EXPECT_TRUE(r3->isLeader);
+
+    auto r1 = w1.poll(cx);
+    auto r2 = w2.poll(cx);
+    ASSERT_TRUE(r1);
+    ASSERT_TRUE(r2);
+    EXPECT_FALSE(r1->isLeader);
+    EXPECT_FALSE(r2->isLeader);
+}
+
+TEST(Barrier, DroppedWaiterWithdraws) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Barrier barrier{2};
+
+    {
+        auto w = barrier.wait();
+        EXPECT_FALSE(w.poll(cx));
+    }
+
+    // the dropped waiter no longer counts, so this one has to wait
+    auto w1 = barrier.wait();
+    EXPECT_FALSE(w1.poll(cx));
+
+    auto w2 = barrier.wait();
+    EXPECT_TRUE(w2.poll(cx));
+    EXPECT_TRUE(w1.poll(cx));
+}
+
+TEST(Barrier, Reusable) {
+    auto rt = Runtime::create(4);
+    Barrier barrier{4};
+    std::atomic<size_t> leaders{0};
+    std::atomic<size_t> phase{0};
+
+    std::vector<TaskHandle<void>> handles;
+    for (size_t i = 0; i < 4; i++) {
+        handles.push_back(rt->spawn([&] -> Future<> {
+            for (size_t round = 0; round < 10; round++) {
+                EXPECT_EQ(phase.load() / 4, round);
+                phase.fetch_add(1);
+
+                auto res = co_await barrier.wait();
+                if (res.isLeader) leaders.fetch_add(1);
+
+                // everyone in this round has arrived before anyone continues
+                EXPECT_GE(phase.load(), (round + 1) * 4);
+                co_await barrier.wait();
+            }
+        }));
+    }
+
+    for (auto& h : handles) {
+        h.blockOn();
+    }
+
+    EXPECT_EQ(leaders.load(), 10);
+}
+
+TEST(Barrier, ConcurrentDestroyOnRelease) {
+    constexpr size_t WAITERS = 4;
+
+    for (size_t round = 0; round < 200; round++) {
+        Waker waker = Waker::noop();
+        Context cx { &waker };
+        Barrier barrier{WAITERS + 1};
+
+        std::vector<std::unique_ptr<Barrier::Awaiter>> waiters;
+        for (size_t i = 0; i < WAITERS; i++) {
+            waiters.push_back(std::make_unique<Barrier::Awaiter>(barrier.wait()));
+            EXPECT_FALSE(waiters.back()->poll(cx));
+        }
+
+        // every thread keeps polling its awaiter without being woken, and frees it as soon as it is released,
+        // possibly while the leader is still releasing the others
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (auto& w : waiters) {
+            threads.emplace_back([&go, w = std::move(w)] mutable {
+                Waker waker = Waker::noop();
+                Context cx { &waker };
+
+                while (!go.load()) {}
+                while (!w->poll(cx)) {}
+                w.reset();
+            });
+        }
+
+        go.store(true);
+        auto leader = barrier.wait();
+        auto res = leader.poll(cx);
+        ASSERT_TRUE(res);
+        EXPECT_TRUE(res->isLeader);
+
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include <arc/task/CancellationToken.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <arc/time/Sleep.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+TEST(CancellationToken, Basic) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    CancellationToken token;
+    auto copy = token;
+    auto waiter = copy.waitCancelled();
+
+    EXPECT_FALSE(waiter.poll(cx));
+    EXPECT_FALSE(copy.isCancelled());
+
+    token.cancel();
+    EXPECT_TRUE(copy.isCancelled());
+    EXPECT_TRUE(waiter.poll(cx));
+}
+
+TEST(CancellationToken, Children) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    CancellationToken root;
+    auto a = root.child();
+    auto b = root.child();
+    auto aa = a.child();
+    auto waiter = aa.waitCancelled();
+    EXPECT_FALSE(waiter.poll(cx));
+
+    // cancelling a child does not affect the parent or siblings
+    b.cancel();
+    EXPECT_TRUE(b.isCancelled());
+    EXPECT_FALSE(root.isCancelled());
+    EXPECT_FALSE(a.isCancelled());
+
+    {
+        // dropped children unlink themselves
+        auto temp = a.child();
+        auto temp2 = temp.child();
+    }
+
+    root.cancel();
+    EXPECT_TRUE(a.isCancelled());
+    EXPECT_TRUE(aa.isCancelled());
+    EXPECT_TRUE(waiter.poll(cx));
+
+    // children of a cancelled token start out cancelled
+    EXPECT_TRUE(root.child().isCancelled());
+}
+
+TEST(CancellationToken, ChildOutlivesParent) {
+    CancellationToken child;
+    {
+        CancellationToken parent;
+        child = parent.child();
+    }
+
+    EXPECT_FALSE(child.isCancelled());
+    child.cancel();
+    EXPECT_TRUE(child.isCancelled());
+}
+
+TEST(CancellationToken, RunUntilCancelled) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    CancellationToken token;
+    Notify notify;
+
+    auto fut = token.runUntilCancelled(notify.notified());
+    EXPECT_FALSE(fut.poll(cx));
+
+    notify.notifyOne();
+    auto res = fut.poll(cx);
+    ASSERT_TRUE(res);
+    EXPECT_TRUE(res->has_value());
+
+    auto fut2 = token.runUntilCancelled(notify.notified());
+    EXPECT_FALSE(fut2.poll(cx));
+
+    token.cancel();
+    res = fut2.poll(cx);
+    ASSERT_TRUE(res);
+    EXPECT_FALSE(res->has_value());
+}
+
+TEST(CancellationToken, AbortsSleep) {
+    auto rt = Runtime::create(2);
+    CancellationToken token;
+
+    auto handle = rt->spawn([token] -> Future<bool> {
+        auto res = co_await token.child().runUntilCancelled(sleep(asp::Duration::fromSecs(60)));
+        co_return res.has_value();
+    });
+
+    rt->spawn([token] -> Future<> {
+        co_await sleep(asp::Duration::fromMillis(5));
+        token.cancel();
+    });
+
+    EXPECT_FALSE(handle.blockOn());
+}
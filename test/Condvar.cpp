@@ -0,0 +1,116 @@
+#include <arc/sync/Condvar.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <gtest/gtest.h>
+#include <deque>
+
+using namespace arc;
+
+TEST(Condvar, WaitAndNotify) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Mutex<int> mtx{0};
+    Condvar cv;
+
+    auto guard = mtx.tryLock();
+    ASSERT_TRUE(guard);
+
+    auto waiter = cv.wait(std::move(*guard));
+    EXPECT_FALSE(waiter.poll(cx));
+
+    // the mutex was released while waiting
+    auto other = mtx.tryLock();
+    ASSERT_TRUE(other);
+    **other = 5;
+
+    cv.notifyOne();
+
+    // notified, but the mutex is still held
+    EXPECT_FALSE(waiter.poll(cx));
+    other.reset();
+
+    auto relocked = waiter.poll(cx);
+    ASSERT_TRUE(relocked);
+    EXPECT_EQ(**relocked, 5);
+}
+
+TEST(Condvar, NotifyAll) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Mutex<> mtx;
+    Condvar cv;
+
+    auto w1 = cv.wait(*mtx.tryLock());
+    EXPECT_FALSE(w1.poll(cx));
+    auto w2 = cv.wait(*mtx.tryLock());
+    EXPECT_FALSE(w2.poll(cx));
+
+    // without waiters this does nothing
+    Condvar other;
+    other.notifyAll();
+
+    cv.notifyAll();
+
+    auto g1 = w1.poll(cx);
+    ASSERT_TRUE(g1);
+    EXPECT_FALSE(w2.poll(cx)); // w1 holds the mutex
+    g1.reset();
+    EXPECT_TRUE(w2.poll(cx));
+}
+
+TEST(Condvar, DroppedWaiterPassesNotification) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Mutex<> mtx;
+    Condvar cv;
+
+    auto w2 = std::optional<Condvar::WaitAwaiter<std::monostate, Mutex<>>>{};
+
+    {
+        auto w1 = cv.wait(*mtx.tryLock());
+        EXPECT_FALSE(w1.poll(cx));
+
+        w2.emplace(cv.wait(*mtx.tryLock()));
+        EXPECT_FALSE(w2->poll(cx));
+
+        cv.notifyOne();
+    }
+
+    // w1 was notified but dropped, so w2 receives the notification instead
+    EXPECT_TRUE(w2->poll(cx));
+}
+
+TEST(Condvar, ProducerConsumer) {
+    auto rt = Runtime::create(4);
+    Mutex<std::deque<int>> queue;
+    Condvar cv;
+    constexpr int Count = 1000;
+
+    auto consumer = rt->spawn([&] -> Future<int> {
+        int sum = 0;
+
+        for (int i = 0; i < Count; i++) {
+            auto guard = co_await queue.lock();
+            while (guard->empty()) {
+                guard = co_await cv.wait(std::move(guard));
+            }
+
+            sum += guard->front();
+            guard->pop_front();
+        }
+
+        co_return sum;
+    });
+
+    auto producer = rt->spawn([&] -> Future<> {
+        for (int i = 0; i < Count; i++) {
+            (co_await queue.lock())->push_back(i);
+            cv.notifyOne();
+        }
+    });
+
+    producer.blockOn();
+    EXPECT_EQ(consumer.blockOn(), Count * (Count - 1) / 2);
+}
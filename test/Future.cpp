@@ -80,3 +80,104 @@ TEST(Future, ExceptionNestedCatch) {
 
     EXPECT_NO_THROW(rt->blockOn(fut()));
 }
+
+static Future<int> nestedYield(int depth, int yields) {
+    if (depth == 0) {
+        for (int i = 0; i < yields; i++) {
+            co_await arc::yield();
+        }
+        co_return 0;
+    }
+
+    co_return co_await nestedYield(depth - 1, yields) + 1;
+}
+
+TEST(Future, DeepNesting) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    // way deeper than a recursive poll would allow, every poll only resumes the innermost future
+    auto fut = nestedYield(2000, 3);
+
+    size_t polls = 1;
+    while (!fut.poll(cx)) {
+        polls++;
+    }
+
+    EXPECT_EQ(polls, 4);
+    EXPECT_EQ(fut.getOutput(), 2000);
+}
+
+TEST(Future, AwaitPolledFuture) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto inner = nestedYield(5, 2);
+    EXPECT_FALSE(inner.poll(cx));
+
+    // the inner future already started on its own, awaiting it must still work
+    auto outer = [&] -> Future<int> {
+        co_return co_await std::move(inner) * 2;
+    }();
+
+    EXPECT_FALSE(outer.poll(cx));
+    EXPECT_TRUE(outer.poll(cx));
+    EXPECT_EQ(outer.getOutput(), 10);
+}
+
+TEST(Future, DeepNestingException) {
+    auto rt = Runtime::create(1);
+
+    auto thrower = [](this auto self, int depth) -> Future<int> {
+        if (depth == 0) {
+            co_await arc::yield();
+            throw std::runtime_error("deep exception");
+        }
+
+        co_return co_await self(depth - 1) + 1;
+    };
+
+    EXPECT_THROW(rt->blockOn(thrower(100)), std::runtime_error);
+}
+
+static Future<> markedFrames(int depth) {
+    auto cx = (co_await PromiseBase::current())->getContext();
+    cx->markFrame(asp::UniqueBoxedString{fmt::format("frame {}", depth)});
+
+    if (depth == 0) {
+        co_await arc::yield();
+        cx = (co_await PromiseBase::current())->getContext();
+        cx->printFutureStack();
+        co_return;
+    }
+
+    co_await markedFrames(depth - 1);
+}
+
+TEST(Future, StackReconstruction) {
+    std::vector<std::string> lines;
+    arc::setLogFunction([&](std::string msg, LogLevel) {
+        lines.push_back(std::move(msg));
+    });
+
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto fut = markedFrames(2);
+    while (!fut.poll(cx)) {}
+
+    arc::setLogFunction({});
+
+    // no frames are pushed while polling, the stack is rebuilt from the links between the futures
+    std::vector<std::string> frames;
+    for (auto& line : lines) {
+        if (line.find("frame ") != std::string::npos) {
+            frames.push_back(line.substr(line.find("frame ")));
+        }
+    }
+
+    ASSERT_EQ(frames.size(), 3);
+    EXPECT_EQ(frames[0], "frame 0");
+    EXPECT_EQ(frames[1], "frame 1");
+    EXPECT_EQ(frames[2], "frame 2");
+}
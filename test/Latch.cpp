@@ -0,0 +1,63 @@
+#include <arc/sync/Latch.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+TEST(Latch, CountDown) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Latch latch{2};
+    auto w1 = latch.wait();
+    auto w2 = latch.wait();
+
+    EXPECT_FALSE(w1.poll(cx));
+    EXPECT_FALSE(w2.poll(cx));
+    EXPECT_FALSE(latch.tryWait());
+
+    latch.countDown();
+    EXPECT_FALSE(w1.poll(cx));
+    EXPECT_EQ(latch.count(), 1);
+
+    latch.countDown();
+    EXPECT_TRUE(w1.poll(cx));
+    EXPECT_TRUE(w2.poll(cx));
+    EXPECT_TRUE(latch.tryWait());
+
+    // waiting on an open latch completes immediately
+    EXPECT_TRUE(latch.wait().poll(cx));
+}
+
+TEST(Latch, DropWhileWaiting) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Latch latch{1};
+    {
+        auto w = latch.wait();
+        EXPECT_FALSE(w.poll(cx));
+    }
+
+    latch.countDown();
+    EXPECT_TRUE(latch.tryWait());
+}
+
+TEST(Latch, ArriveAndWait) {
+    auto rt = Runtime::create(4);
+    Latch latch{8};
+    std::atomic<size_t> arrived{0};
+
+    std::vector<TaskHandle<void>> handles;
+    for (size_t i = 0; i < 8; i++) {
+        handles.push_back(rt->spawn([&] -> Future<> {
+            arrived.fetch_add(1);
+            co_await latch.arriveAndWait();
+            EXPECT_EQ(arrived.load(), 8);
+        }));
+    }
+
+    for (auto& h : handles) {
+        h.blockOn();
+    }
+}
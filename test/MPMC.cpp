@@ -0,0 +1,190 @@
+#include <arc/sync/mpmc.hpp>
+#include <arc/task/Yield.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <arc/util/ManuallyDrop.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+TEST(MPMC, Basic) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = mpmc::channel<int>(3);
+
+    EXPECT_TRUE(tx.trySend(1).isOk());
+    EXPECT_TRUE(tx.trySend(2).isOk());
+    EXPECT_TRUE(tx.trySend(3).isOk());
+    EXPECT_FALSE(tx.trySend(4).isOk());
+    EXPECT_FALSE(tx.hasCapacity());
+
+    auto fut = tx.send(4);
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    EXPECT_EQ(rx.tryRecv().unwrap(), 1);
+    EXPECT_TRUE(fut.poll(cx).has_value());
+
+    for (int expected : {2, 3, 4}) {
+        auto r = rx.tryRecv();
+        EXPECT_TRUE(r.isOk());
+        EXPECT_EQ(r.unwrap(), expected);
+    }
+
+    auto r = rx.tryRecv();
+    EXPECT_TRUE(r.isErr());
+    EXPECT_TRUE(r.unwrapErr() == mpmc::TryRecvOutcome::Empty);
+}
+
+TEST(MPMC, Wraparound) {
+    auto [tx, rx] = mpmc::channel<int>(3);
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(tx.trySend(i).isOk());
+        EXPECT_TRUE(tx.trySend(i + 1000).isOk());
+        EXPECT_EQ(rx.tryRecv().unwrap(), i);
+        EXPECT_EQ(rx.tryRecv().unwrap(), i + 1000);
+    }
+
+    EXPECT_TRUE(rx.empty());
+}
+
+TEST(MPMC, ReceiversWokenInOrder) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = mpmc::channel<int>(4);
+    auto rx2 = rx;
+
+    auto r1 = rx.recv();
+    auto r2 = rx2.recv();
+    EXPECT_FALSE(r1.poll(cx).has_value());
+    EXPECT_FALSE(r2.poll(cx).has_value());
+
+    EXPECT_TRUE(tx.trySend(1).isOk());
+
+    // only the first receiver was notified, the second one stays waiting
+    EXPECT_FALSE(r2.poll(cx).has_value());
+    auto p1 = r1.poll(cx);
+    EXPECT_TRUE(p1.has_value());
+    EXPECT_EQ(p1->unwrap(), 1);
+
+    EXPECT_TRUE(tx.trySend(2).isOk());
+    auto p2 = r2.poll(cx);
+    EXPECT_TRUE(p2.has_value());
+    EXPECT_EQ(p2->unwrap(), 2);
+}
+
+TEST(MPMC, DroppedWaiterForwardsNotification) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = mpmc::channel<int>(4);
+
+    auto r2 = rx.recv();
+    {
+        auto r1 = rx.recv();
+        EXPECT_FALSE(r1.poll(cx).has_value());
+        EXPECT_FALSE(r2.poll(cx).has_value());
+
+        // r1 gets notified but is destroyed before taking the value
+        EXPECT_TRUE(tx.trySend(1).isOk());
+    }
+
+    auto p = r2.poll(cx);
+    EXPECT_TRUE(p.has_value());
+    EXPECT_EQ(p->unwrap(), 1);
+}
+
+TEST(MPMC, ClosedBySenders) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = mpmc::channel<int>(2);
+    auto rx2 = rx;
+    EXPECT_TRUE(tx.trySend(1).isOk());
+
+    auto waiting = rx2.recv();
+    EXPECT_TRUE(waiting.poll(cx).has_value());
+
+    auto waiting2 = rx2.recv();
+    EXPECT_FALSE(waiting2.poll(cx).has_value());
+
+    arc::drop(std::move(tx));
+
+    auto p = waiting2.poll(cx);
+    EXPECT_TRUE(p.has_value());
+    EXPECT_TRUE(p->isErr());
+
+    auto r = rx.tryRecv();
+    EXPECT_TRUE(r.isErr());
+    EXPECT_TRUE(r.unwrapErr() == mpmc::TryRecvOutcome::Closed);
+}
+
+TEST(MPMC, ClosedByReceivers) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = mpmc::channel<int>(1);
+    auto rx2 = rx;
+    EXPECT_TRUE(tx.trySend(1).isOk());
+
+    auto fut = tx.send(2);
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    // dropping only one receiver keeps the channel open
+    arc::drop(std::move(rx));
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    arc::drop(std::move(rx2));
+
+    auto p = fut.poll(cx);
+    EXPECT_TRUE(p.has_value());
+    EXPECT_TRUE(p->isErr());
+    EXPECT_EQ(p->unwrapErr(), 2);
+}
+
+TEST(MPMC, WorkerPool) {
+    auto rt = arc::Runtime::create(4);
+    auto [tx, rx] = mpmc::channel<int>(16);
+    auto [outTx, outRx] = mpmc::channel<uint64_t>(8);
+
+    auto [a, b] = rt->blockOn([&] -> arc::Future<std::pair<uint64_t, uint64_t>> {
+        constexpr size_t Workers = 8;
+
+        for (size_t i = 0; i < Workers; i++) {
+            arc::spawn([outTx, rx] mutable -> arc::Future<> {
+                uint64_t sum = 0;
+
+                while (true) {
+                    auto res = co_await rx.recv();
+                    if (!res) break;
+                    sum += *res;
+                    co_await arc::yield();
+                }
+
+                EXPECT_TRUE((co_await outTx.send(sum)).isOk());
+            });
+        }
+
+        arc::drop(std::move(rx));
+
+        uint64_t actualSum = 0;
+        for (int i = 0; i < 4096; i++) {
+            EXPECT_TRUE((co_await tx.send(i)).isOk());
+            actualSum += i;
+        }
+
+        arc::drop(std::move(tx)); // this should close the channel
+
+        uint64_t taskSum = 0;
+        for (size_t i = 0; i < Workers; i++) {
+            auto res = co_await outRx.recv();
+            EXPECT_TRUE(res.isOk());
+            taskSum += *res;
+        }
+
+        co_return std::make_pair(actualSum, taskSum);
+    });
+
+    EXPECT_EQ(a, b);
+}
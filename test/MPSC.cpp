@@ -44,6 +44,33 @@ TEST(MPSC, VeryBasicSync) {
     trace("10");
 }
 
+TEST(MPSC, CoopBudget) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+    cx._setBudget(2);
+
+    auto [tx, rx] = mpsc::channel<int>(3);
+    EXPECT_TRUE(tx.trySend(1).isOk());
+    EXPECT_TRUE(tx.trySend(2).isOk());
+    EXPECT_TRUE(tx.trySend(3).isOk());
+
+    auto r1 = rx.recv();
+    EXPECT_TRUE(r1.poll(cx).has_value());
+    auto r2 = rx.recv();
+    EXPECT_TRUE(r2.poll(cx).has_value());
+
+    // the value is there, but the budget is spent
+    auto r3 = rx.recv();
+    EXPECT_FALSE(r3.poll(cx).has_value());
+    EXPECT_EQ(cx.remainingBudget(), 0);
+
+    // the next poll of the task starts with a fresh budget
+    cx._setBudget(2);
+    auto res = r3.poll(cx);
+    EXPECT_TRUE(res.has_value());
+    EXPECT_EQ(res->unwrap(), 3);
+}
+
 TEST(MPSC, Basic) {
     Waker waker = Waker::noop();
     Context cx { &waker };
@@ -0,0 +1,140 @@
+#include <arc/sync/Mutex.hpp>
+#include <arc/task/Yield.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+TEST(Mutex, Uncontended) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Mutex<int> mtx{1};
+
+    {
+        auto fut = mtx.lock();
+        auto guard = fut.poll(cx);
+        EXPECT_TRUE(guard.has_value());
+        EXPECT_EQ(**guard, 1);
+        **guard = 2;
+
+        EXPECT_FALSE(mtx.tryLock().has_value());
+    }
+
+    auto guard = mtx.tryLock();
+    EXPECT_TRUE(guard.has_value());
+    EXPECT_EQ(**guard, 2);
+}
+
+TEST(Mutex, Contended) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Mutex<int> mtx{0};
+    auto first = mtx.tryLock();
+    EXPECT_TRUE(first.has_value());
+
+    auto fut1 = mtx.lock();
+    auto fut2 = mtx.lock();
+    EXPECT_FALSE(fut1.poll(cx).has_value());
+    EXPECT_FALSE(fut2.poll(cx).has_value());
+
+    // unlocking hands the mutex over to the first waiter
+    first.reset();
+    EXPECT_FALSE(mtx.tryLock().has_value());
+    EXPECT_FALSE(fut2.poll(cx).has_value());
+
+    auto g1 = fut1.poll(cx);
+    EXPECT_TRUE(g1.has_value());
+    g1.reset();
+
+    auto g2 = fut2.poll(cx);
+    EXPECT_TRUE(g2.has_value());
+}
+
+TEST(Mutex, DroppedWaiter) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Mutex<> mtx;
+    auto first = mtx.tryLock();
+
+    {
+        auto fut = mtx.lock();
+        EXPECT_FALSE(fut.poll(cx).has_value());
+    }
+
+    first.reset();
+    EXPECT_TRUE(mtx.tryLock().has_value());
+}
+
+TEST(Mutex, ManyTasks) {
+    auto rt = arc::Runtime::create(4);
+    Mutex<uint64_t> mtx{0};
+
+    rt->blockOn([&] -> arc::Future<> {
+        std::vector<arc::TaskHandle<void>> handles;
+
+        for (size_t i = 0; i < 16; i++) {
+            handles.push_back(arc::spawn([&] -> arc::Future<> {
+                for (size_t j = 0; j < 256; j++) {
+                    auto guard = co_await mtx.lock();
+                    *guard += 1;
+                    co_await arc::yield();
+                }
+            }));
+        }
+
+        for (auto& handle : handles) {
+            co_await handle;
+        }
+    });
+
+    EXPECT_EQ(*mtx.blockingLock(), 16 * 256);
+}
+
+TEST(Mutex, Barging) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Mutex<> mtx{Fairness::Barging};
+    auto first = mtx.tryLock();
+    ASSERT_TRUE(first.has_value());
+
+    auto fut = mtx.lock();
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    // unlocking only signals the waiter, so the lock can be taken again right away
+    first.reset();
+    auto barger = mtx.tryLock();
+    EXPECT_TRUE(barger.has_value());
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    barger.reset();
+    EXPECT_TRUE(fut.poll(cx).has_value());
+}
+
+TEST(Mutex, ManyTasksBarging) {
+    auto rt = arc::Runtime::create(4);
+    Mutex<uint64_t> mtx{0, Fairness::Barging};
+
+    rt->blockOn([&] -> arc::Future<> {
+        std::vector<arc::TaskHandle<void>> handles;
+
+        for (size_t i = 0; i < 16; i++) {
+            handles.push_back(arc::spawn([&] -> arc::Future<> {
+                for (size_t j = 0; j < 256; j++) {
+                    auto guard = co_await mtx.lock();
+                    *guard += 1;
+                    co_await arc::yield();
+                }
+            }));
+        }
+
+        for (auto& handle : handles) {
+            co_await handle;
+        }
+    });
+
+    EXPECT_EQ(*mtx.blockingLock(), 16 * 256);
+}
@@ -49,3 +49,65 @@ TEST(Notify, MultipleWaiters) {
     EXPECT_TRUE(w2.poll(cx));
     EXPECT_TRUE(w3.poll(cx));
 }
+
+TEST(Notify, NotifyAllBeforePoll) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    arc::Notify notify;
+    auto w1 = notify.notified();
+
+    // w1 was created before notifyAll, so it completes even though it was never polled
+    notify.notifyAll();
+    auto w2 = notify.notified();
+
+    EXPECT_TRUE(w1.poll(cx));
+    EXPECT_FALSE(w2.poll(cx));
+
+    // notifyAll does not store a permit
+    auto w3 = notify.notified();
+    EXPECT_FALSE(w3.poll(cx));
+
+    notify.notifyAll();
+    EXPECT_TRUE(w2.poll(cx));
+    EXPECT_TRUE(w3.poll(cx));
+}
+
+TEST(Notify, DroppedWaiter) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    arc::Notify notify;
+
+    {
+        auto w1 = notify.notified();
+        EXPECT_FALSE(w1.poll(cx));
+    }
+
+    // the only waiter is gone, so the permit gets stored instead
+    notify.notifyOne();
+
+    auto w2 = notify.notified();
+    EXPECT_TRUE(w2.poll(cx));
+
+    auto w3 = notify.notified();
+    EXPECT_FALSE(w3.poll(cx));
+}
+
+TEST(Notify, Reset) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    arc::Notify notify;
+    auto w = notify.notified();
+    EXPECT_FALSE(w.poll(cx));
+
+    notify.notifyAll();
+    EXPECT_TRUE(w.poll(cx));
+
+    // after a reset, the previous notifyAll is not observed again
+    w.reset();
+    EXPECT_FALSE(w.poll(cx));
+    notify.notifyOne();
+    EXPECT_TRUE(w.poll(cx));
+}
@@ -0,0 +1,120 @@
+#include <arc/sync/OnceCell.hpp>
+#include <arc/sync/Notify.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <arc/task/Yield.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+TEST(OnceCell, SetAndGet) {
+    OnceCell<int> cell;
+    EXPECT_EQ(cell.get(), nullptr);
+
+    EXPECT_TRUE(cell.set(5));
+    EXPECT_FALSE(cell.set(6));
+
+    ASSERT_NE(cell.get(), nullptr);
+    EXPECT_EQ(*cell.get(), 5);
+}
+
+TEST(OnceCell, SingleInitializer) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    OnceCell<int> cell;
+    Notify notify;
+    size_t calls = 0;
+
+    auto init = [&] -> Future<int> {
+        calls++;
+        co_await notify.notified();
+        co_return 42;
+    };
+
+    auto a = cell.getOrInit(init);
+    auto b = cell.getOrInit(init);
+
+    EXPECT_FALSE(a.poll(cx));
+    EXPECT_FALSE(b.poll(cx));
+    EXPECT_EQ(calls, 1);
+
+    notify.notifyOne();
+    auto ra = a.poll(cx);
+    auto rb = b.poll(cx);
+    ASSERT_TRUE(ra);
+    ASSERT_TRUE(rb);
+    EXPECT_EQ(ra->get(), 42);
+    EXPECT_EQ(&ra->get(), &rb->get());
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(OnceCell, CancelledInitializer) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    OnceCell<int> cell;
+    Notify notify;
+
+    auto b = cell.getOrInit([&] -> Future<int> { co_return 2; });
+
+    {
+        auto a = cell.getOrInit([&] -> Future<int> {
+            co_await notify.notified();
+            co_return 1;
+        });
+
+        EXPECT_FALSE(a.poll(cx));
+        EXPECT_FALSE(b.poll(cx));
+    }
+
+    // the first initializer was dropped, so the waiter takes over
+    auto res = b.poll(cx);
+    ASSERT_TRUE(res);
+    EXPECT_EQ(res->get(), 2);
+    EXPECT_EQ(*cell.get(), 2);
+}
+
+TEST(OnceCell, ThrowingInitializer) {
+    auto rt = Runtime::create(1);
+    OnceCell<int> cell;
+
+    EXPECT_THROW(rt->spawn([&] -> Future<> {
+        co_await cell.getOrInit([] -> Future<int> {
+            throw std::runtime_error("failed");
+            co_return 0;
+        });
+    }).blockOn(), std::runtime_error);
+
+    EXPECT_FALSE(cell.isInitialized());
+
+    auto value = rt->spawn([&] -> Future<int> {
+        int& v = co_await cell.getOrInit([] -> Future<int> { co_return 7; });
+        co_return v;
+    }).blockOn();
+
+    EXPECT_EQ(value, 7);
+}
+
+TEST(OnceCell, Concurrent) {
+    auto rt = Runtime::create(4);
+    OnceCell<std::string> cell;
+    std::atomic<size_t> calls{0};
+
+    std::vector<TaskHandle<void>> handles;
+    for (size_t i = 0; i < 16; i++) {
+        handles.push_back(rt->spawn([&] -> Future<> {
+            std::string& value = co_await cell.getOrInit([&] -> Future<std::string> {
+                calls.fetch_add(1);
+                co_await yield();
+                co_return "hello";
+            });
+            EXPECT_EQ(value, "hello");
+        }));
+    }
+
+    for (auto& h : handles) {
+        h.blockOn();
+    }
+
+    EXPECT_EQ(calls.load(), 1);
+}
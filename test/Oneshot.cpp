@@ -58,3 +58,40 @@ TEST(Oneshot, RecvAfterClosure) {
     EXPECT_TRUE(pres->isErr());
 }
 
+
+TEST(Oneshot, SenderSeesClosure) {
+    auto [tx, rx] = oneshot::channel<std::string>();
+    EXPECT_FALSE(tx.isClosed());
+
+    arc::drop(std::move(rx));
+    EXPECT_TRUE(tx.isClosed());
+}
+
+TEST(Oneshot, UnreceivedValueIsDestroyed) {
+    auto ptr = std::make_shared<int>(5);
+    std::weak_ptr<int> weak = ptr;
+
+    {
+        auto [tx, rx] = oneshot::channel<std::shared_ptr<int>>();
+        EXPECT_TRUE(tx.send(std::move(ptr)).isOk());
+        EXPECT_FALSE(weak.expired());
+    }
+
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(Oneshot, AwaiterOutlivesReceiver) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = oneshot::channel<int>();
+    auto fut = rx.recv();
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    arc::drop(std::move(rx));
+    arc::drop(std::move(tx));
+
+    auto res = fut.poll(cx);
+    EXPECT_TRUE(res.has_value());
+    EXPECT_TRUE(res->isErr());
+}
@@ -0,0 +1,66 @@
+#include <arc/task/Parker.hpp>
+#include <asp/time/Instant.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace arc;
+using namespace asp::time;
+
+TEST(Parker, UnparkBeforePark) {
+    Parker parker;
+
+    // the token is stored, so park returns immediately
+    parker.unpark();
+    parker.park();
+
+    // only a single token is stored
+    parker.unpark();
+    parker.unpark();
+    EXPECT_TRUE(parker.parkTimeout(Duration::fromMillis(1)));
+    EXPECT_FALSE(parker.parkTimeout(Duration::fromMillis(1)));
+}
+
+TEST(Parker, Timeout) {
+    Parker parker;
+
+    auto start = Instant::now();
+    EXPECT_FALSE(parker.parkTimeout(Duration::fromMillis(20)));
+    EXPECT_GE(start.elapsed().millis(), 15);
+}
+
+TEST(Parker, CrossThread) {
+    Parker parker;
+    std::atomic<bool> flag{false};
+
+    std::thread t([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        flag.store(true);
+        parker.unpark();
+    });
+
+    while (!flag.load()) {
+        parker.park();
+    }
+
+    EXPECT_TRUE(flag.load());
+    t.join();
+}
+
+TEST(Parker, PingPong) {
+    Parker a, b;
+    constexpr size_t Rounds = 10000;
+
+    std::thread t([&] {
+        for (size_t i = 0; i < Rounds; i++) {
+            a.park();
+            b.unpark();
+        }
+    });
+
+    for (size_t i = 0; i < Rounds; i++) {
+        a.unpark();
+        b.park();
+    }
+
+    t.join();
+}
@@ -0,0 +1,99 @@
+#include <arc/util/Pool.hpp>
+#include <arc/future/Future.hpp>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace arc;
+
+TEST(Pool, Recycles) {
+    void* a = pool::allocate(100);
+    std::memset(a, 0xaa, 100);
+    pool::deallocate(a);
+
+    // same size class on the same thread, so the block is reused
+    void* b = pool::allocate(120);
+    EXPECT_EQ(a, b);
+    pool::deallocate(b);
+
+    // too large to be pooled, but still works
+    void* big = pool::allocate(pool::MAX_POOLED_SIZE * 4);
+    std::memset(big, 0xbb, pool::MAX_POOLED_SIZE * 4);
+    pool::deallocate(big);
+
+    pool::deallocate(nullptr);
+}
+
+TEST(Pool, Alignment) {
+    for (size_t size : {1, 17, 64, 65, 1000, 4096, 5000}) {
+        void* p = pool::allocate(size);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0);
+        pool::deallocate(p);
+    }
+}
+
+TEST(Pool, CrossThreadFree) {
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 1000; i++) {
+        blocks.push_back(pool::allocate(64 + i % 512));
+    }
+
+    std::thread t([&] {
+        for (auto p : blocks) pool::deallocate(p);
+    });
+    t.join();
+
+    // the remotely freed blocks come back to this thread
+    void* p = pool::allocate(64);
+    pool::deallocate(p);
+}
+
+TEST(Pool, OwnerExitsFirst) {
+    std::vector<void*> blocks;
+
+    std::thread t([&] {
+        for (size_t i = 0; i < 1000; i++) {
+            blocks.push_back(pool::allocate(256));
+        }
+    });
+    t.join();
+
+    // the owning thread is gone, freeing must still work
+    for (auto p : blocks) pool::deallocate(p);
+}
+
+TEST(Pool, Stats) {
+    auto before = pool::threadStats();
+
+    void* a = pool::allocate(200);
+    pool::deallocate(a);
+    void* b = pool::allocate(200);
+    pool::deallocate(b);
+
+    void* big = pool::allocate(pool::MAX_POOLED_SIZE + 1);
+    pool::deallocate(big);
+
+    auto after = pool::threadStats();
+    EXPECT_GE(after.hits - before.hits, 1);
+    EXPECT_GE(after.misses - before.misses, 1);
+    EXPECT_EQ((after.hits + after.misses) - (before.hits + before.misses), 3);
+}
+
+static Future<int> frameCoro(int x) {
+    co_return x * 2;
+}
+
+TEST(Pool, CoroutineFrames) {
+    // warm up the size class of this frame
+    (void) frameCoro(1);
+
+    auto before = pool::threadStats();
+    for (int i = 0; i < 100; i++) {
+        (void) frameCoro(i);
+    }
+    auto after = pool::threadStats();
+
+    EXPECT_EQ(after.hits - before.hits, 100);
+    EXPECT_EQ(after.misses, before.misses);
+}
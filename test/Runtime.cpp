@@ -1,6 +1,7 @@
 #include <arc/prelude.hpp>
 #include <gtest/gtest.h>
 #include <signal.h>
+#include <thread>
 
 using namespace arc;
 
@@ -78,6 +79,94 @@ TEST(Runtime, ShutdownWithTasks) {
     rt->safeShutdown();
 }
 
+TEST(Runtime, ShutdownWithManyTasks) {
+    auto rt = arc::Runtime::create(4);
+    arc::Notify notify;
+    std::atomic<size_t> finished{0};
+
+    // spawn from several workers at once, half of the tasks finish and unregister, the rest are aborted on shutdown
+    std::vector<arc::TaskHandle<void>> spawners;
+    for (size_t i = 0; i < 4; i++) {
+        spawners.push_back(rt->spawn([&] -> arc::Future<> {
+            for (size_t j = 0; j < 250; j++) {
+                if (j % 2 == 0) {
+                    arc::spawn([&] -> arc::Future<> {
+                        finished.fetch_add(1);
+                        co_return;
+                    });
+                } else {
+                    arc::spawn([&] -> arc::Future<> {
+                        co_await notify.notified();
+                    });
+                }
+            }
+            co_return;
+        }));
+    }
+
+    for (auto& h : spawners) {
+        h.blockOn();
+    }
+
+    while (finished.load() < 500) {
+        std::this_thread::yield();
+    }
+
+#ifdef ARC_DEBUG
+    EXPECT_GE(rt->getTaskStats().size(), 500);
+#endif
+
+    rt->safeShutdown();
+}
+
+TEST(Runtime, CoopBudget) {
+    auto rt = arc::Runtime::create(RuntimeOptions { .workers = 1, .coopBudget = 16 });
+    arc::Mutex<int> mtx{0};
+    std::atomic<bool> stop{false};
+
+    // the lock is always free, so with a single worker the other task only gets to run once the budget is spent
+    auto spinner = rt->spawn([&] -> arc::Future<> {
+        while (!stop.load()) {
+            auto guard = co_await mtx.lock();
+            *guard += 1;
+        }
+    });
+
+    rt->spawn([&] -> arc::Future<> {
+        stop.store(true);
+        co_return;
+    }).blockOn();
+
+    spinner.blockOn();
+}
+
+TEST(Runtime, WakeBatch) {
+    auto rt = arc::Runtime::create(2);
+    std::atomic<size_t> ran{0};
+    std::vector<arc::TaskHandle<void>> handles;
+
+    {
+        arc::WakeBatch batch{rt.get()};
+
+        for (size_t i = 0; i < 100; i++) {
+            handles.push_back(rt->spawn([&] -> arc::Future<> {
+                ran.fetch_add(1);
+                co_return;
+            }));
+        }
+
+        // the tasks are only published to the run queue once the batch ends
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_EQ(ran.load(), 0);
+    }
+
+    for (auto& h : handles) {
+        h.blockOn();
+    }
+
+    EXPECT_EQ(ran.load(), 100);
+}
+
 TEST(Runtime, MultiRuntimeMpsc) {
     auto rt1 = arc::Runtime::create(1);
     auto rt2 = arc::Runtime::create(1);
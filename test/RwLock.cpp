@@ -0,0 +1,106 @@
+#include <arc/sync/RwLock.hpp>
+#include <arc/task/Yield.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+TEST(RwLock, ConcurrentReaders) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    RwLock<int> lock{5};
+
+    auto r1 = lock.tryRead();
+    auto r2 = lock.tryRead();
+    EXPECT_TRUE(r1.has_value());
+    EXPECT_TRUE(r2.has_value());
+    EXPECT_EQ(**r1, 5);
+
+    auto fut = lock.read();
+    auto r3 = fut.poll(cx);
+    EXPECT_TRUE(r3.has_value());
+    EXPECT_EQ(**r3, 5);
+
+    EXPECT_FALSE(lock.tryWrite().has_value());
+}
+
+TEST(RwLock, WriterExcludes) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    RwLock<int> lock{0};
+
+    {
+        auto w = lock.tryWrite();
+        EXPECT_TRUE(w.has_value());
+        **w = 10;
+
+        EXPECT_FALSE(lock.tryRead().has_value());
+        EXPECT_FALSE(lock.tryWrite().has_value());
+    }
+
+    auto r = lock.tryRead();
+    EXPECT_TRUE(r.has_value());
+    EXPECT_EQ(**r, 10);
+}
+
+TEST(RwLock, WritePreferring) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    RwLock<int> lock{0};
+    auto r1 = lock.tryRead();
+
+    // a writer queues up behind the active reader
+    auto wfut = lock.write();
+    EXPECT_FALSE(wfut.poll(cx).has_value());
+
+    // new readers must not overtake the waiting writer
+    EXPECT_FALSE(lock.tryRead().has_value());
+    auto rfut = lock.read();
+    EXPECT_FALSE(rfut.poll(cx).has_value());
+
+    r1.reset();
+
+    auto w = wfut.poll(cx);
+    EXPECT_TRUE(w.has_value());
+    EXPECT_FALSE(rfut.poll(cx).has_value());
+    **w = 1;
+    w.reset();
+
+    auto r2 = rfut.poll(cx);
+    EXPECT_TRUE(r2.has_value());
+    EXPECT_EQ(**r2, 1);
+}
+
+TEST(RwLock, ManyTasks) {
+    auto rt = arc::Runtime::create(4);
+    RwLock<uint64_t> lock{0};
+
+    rt->blockOn([&] -> arc::Future<> {
+        std::vector<arc::TaskHandle<void>> handles;
+
+        for (size_t i = 0; i < 16; i++) {
+            handles.push_back(arc::spawn([&, i] -> arc::Future<> {
+                for (size_t j = 0; j < 256; j++) {
+                    if ((i + j) % 4 == 0) {
+                        auto guard = co_await lock.write();
+                        *guard += 1;
+                    } else {
+                        auto guard = co_await lock.read();
+                        EXPECT_LE(*guard, 16 * 256);
+                    }
+
+                    co_await arc::yield();
+                }
+            }));
+        }
+
+        for (auto& handle : handles) {
+            co_await handle;
+        }
+    });
+
+    EXPECT_EQ(*lock.blockingRead(), 16 * 256 / 4);
+}
@@ -71,3 +71,56 @@ TEST(Semaphore, AcquireBlocking) {
 
     EXPECT_FALSE(sem.tryAcquire(1));
 }
+
+TEST(Semaphore, HasWaiters) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Semaphore sem{1};
+    EXPECT_FALSE(sem.hasWaiters());
+
+    // releasing with no waiters goes straight to the permit count
+    sem.release(1);
+    EXPECT_EQ(sem.permits(), 2);
+    EXPECT_TRUE(sem.tryAcquire(2));
+
+    {
+        auto w = sem.acquire(1);
+        EXPECT_FALSE(w.poll(cx));
+        EXPECT_TRUE(sem.hasWaiters());
+    }
+
+    // dropping the waiter unregisters it
+    EXPECT_FALSE(sem.hasWaiters());
+
+    auto w = sem.acquire(2);
+    EXPECT_FALSE(w.poll(cx));
+    sem.release(1);
+    EXPECT_TRUE(sem.hasWaiters());
+    sem.release(1);
+    EXPECT_FALSE(sem.hasWaiters());
+    EXPECT_TRUE(w.poll(cx));
+}
+
+TEST(Semaphore, BargingStarvationBound) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    Semaphore sem{1, Fairness::Barging};
+    EXPECT_TRUE(sem.tryAcquire());
+
+    auto waiter = sem.acquire();
+    EXPECT_FALSE(waiter.poll(cx));
+
+    // the waiter loses the race every time until the starvation bound kicks in
+    for (size_t i = 0; i < Semaphore::MAX_BARGES; i++) {
+        sem.release();
+        EXPECT_TRUE(sem.tryAcquire());
+        EXPECT_FALSE(waiter.poll(cx));
+    }
+
+    // now the permit is handed over directly, barging is no longer possible
+    sem.release();
+    EXPECT_FALSE(sem.tryAcquire());
+    EXPECT_TRUE(waiter.poll(cx));
+}
@@ -0,0 +1,82 @@
+#include <arc/sync/ShardedSemaphore.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <arc/task/Yield.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace arc;
+
+TEST(ShardedSemaphore, Basic) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    ShardedSemaphore sem{8, 2};
+    EXPECT_TRUE(sem.tryAcquire(3));
+    EXPECT_TRUE(sem.tryAcquire(5));
+    EXPECT_FALSE(sem.tryAcquire(1));
+
+    auto w = sem.acquire(2);
+    EXPECT_FALSE(w.poll(cx));
+
+    sem.release(1);
+    EXPECT_FALSE(w.poll(cx));
+    sem.release(1);
+    EXPECT_TRUE(w.poll(cx));
+
+    sem.release(8);
+    EXPECT_EQ(sem.permits(), 8);
+}
+
+TEST(ShardedSemaphore, CachedPermitsReachWaiters) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    ShardedSemaphore sem{4, 4};
+
+    // park all permits in this thread's cache
+    EXPECT_TRUE(sem.tryAcquire(4));
+    sem.release(4);
+
+    // a waiter on another thread must still get them
+    std::thread t([&] {
+        auto w = sem.acquire(4);
+        while (!w.poll(cx)) {
+            std::this_thread::yield();
+        }
+        sem.release(4);
+    });
+
+    t.join();
+    EXPECT_EQ(sem.permits(), 4);
+}
+
+TEST(ShardedSemaphore, Limit) {
+    auto rt = Runtime::create(4);
+    ShardedSemaphore sem{3, 1};
+    std::atomic<size_t> active{0};
+    std::atomic<size_t> maxActive{0};
+
+    std::vector<TaskHandle<void>> handles;
+    for (size_t i = 0; i < 16; i++) {
+        handles.push_back(rt->spawn([&] -> Future<> {
+            for (size_t j = 0; j < 50; j++) {
+                co_await sem.acquire();
+
+                size_t now = active.fetch_add(1) + 1;
+                size_t prev = maxActive.load();
+                while (now > prev && !maxActive.compare_exchange_weak(prev, now)) {}
+
+                co_await yield();
+                active.fetch_sub(1);
+                sem.release();
+            }
+        }));
+    }
+
+    for (auto& h : handles) {
+        h.blockOn();
+    }
+
+    EXPECT_LE(maxActive.load(), 3);
+    EXPECT_EQ(sem.permits(), 3);
+}
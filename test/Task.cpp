@@ -185,3 +185,19 @@ TEST(Task, ThrowingTaskIgnore) {
     // this is just to assert that there is no crash or anything, since exception should just be logged non fatally
     EXPECT_FALSE(terminated);
 }
+
+TEST(Task, ColdDataRace) {
+    auto runtime = arc::Runtime::create(4);
+
+    // the worker records the exception while this thread names and awaits the task,
+    // both sides may be the first to allocate the cold block
+    for (int i = 0; i < 200; i++) {
+        auto handle = runtime->spawn([] -> arc::Future<int> {
+            throw std::runtime_error("test error");
+            co_return 42;
+        });
+
+        handle.setName("cold");
+        EXPECT_THROW(handle.blockOn(), std::runtime_error);
+    }
+}
@@ -0,0 +1,55 @@
+#include <arc/task/WaitList.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+namespace {
+struct TestAwaiter : WaitListNode {
+    int id;
+    explicit TestAwaiter(int id) : id(id) {}
+};
+}
+
+TEST(WaitList, Order) {
+    Waker waker = Waker::noop();
+    WaitList<TestAwaiter> list;
+
+    TestAwaiter a{1}, b{2}, c{3};
+    list.add(waker, &a);
+    list.add(waker, &b);
+    list.addFront(waker, &c);
+    EXPECT_EQ(list.size(), 3);
+
+    EXPECT_EQ(list.first()->id, 3);
+    EXPECT_EQ(list.takeFirst()->awaiter->id, 3);
+    EXPECT_EQ(list.takeFirst()->awaiter->id, 1);
+    EXPECT_EQ(list.takeFirst()->awaiter->id, 2);
+    EXPECT_FALSE(list.takeFirst().has_value());
+    EXPECT_TRUE(list.empty());
+}
+
+TEST(WaitList, Remove) {
+    Waker waker = Waker::noop();
+    WaitList<TestAwaiter> list;
+
+    TestAwaiter a{1}, b{2}, c{3};
+    list.add(waker, &a);
+    list.add(waker, &b);
+    list.add(waker, &c);
+
+    EXPECT_TRUE(list.remove(&b));
+    EXPECT_FALSE(list.remove(&b));
+    EXPECT_FALSE(b.isLinked());
+
+    EXPECT_TRUE(list.remove(&c));
+    list.add(waker, &b);
+
+    std::vector<int> ids;
+    list.forAll([&](Waker& waker, TestAwaiter* awaiter) {
+        EXPECT_FALSE(awaiter->isLinked());
+        ids.push_back(awaiter->id);
+    });
+
+    EXPECT_EQ(ids, (std::vector<int>{1, 2}));
+    EXPECT_TRUE(list.empty());
+}
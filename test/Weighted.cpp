@@ -0,0 +1,109 @@
+#include <arc/sync/weighted.hpp>
+#include <arc/runtime/Runtime.hpp>
+#include <arc/util/ManuallyDrop.hpp>
+#include <gtest/gtest.h>
+
+using namespace arc;
+
+static size_t bufferWeight(const std::vector<uint8_t>& buf) {
+    return buf.size();
+}
+
+TEST(Weighted, Basic) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = weighted::channel<std::vector<uint8_t>>(100, bufferWeight);
+
+    EXPECT_TRUE(tx.trySend(std::vector<uint8_t>(60)).isOk());
+    EXPECT_EQ(tx.availableBudget(), 40);
+
+    // a heavy value does not fit, but a light one does
+    EXPECT_TRUE(tx.trySend(std::vector<uint8_t>(50)).isErr());
+    EXPECT_TRUE(tx.trySend(std::vector<uint8_t>(10)).isOk());
+
+    auto fut = tx.send(std::vector<uint8_t>(50));
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    // receiving a value frees its weight
+    EXPECT_EQ(rx.tryRecv().unwrap().size(), 60);
+    auto p = fut.poll(cx);
+    EXPECT_TRUE(p.has_value());
+    EXPECT_TRUE(p->isOk());
+
+    EXPECT_EQ(rx.tryRecv().unwrap().size(), 10);
+    EXPECT_EQ(rx.tryRecv().unwrap().size(), 50);
+    EXPECT_EQ(tx.availableBudget(), 100);
+}
+
+TEST(Weighted, OversizedValue) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = weighted::channel<std::vector<uint8_t>>(100, bufferWeight);
+
+    EXPECT_TRUE(tx.trySend(std::vector<uint8_t>(1)).isOk());
+
+    // weight is clamped to the budget, so it can be sent once the channel is empty
+    auto fut = tx.send(std::vector<uint8_t>(1000));
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    EXPECT_TRUE(rx.tryRecv().isOk());
+    EXPECT_TRUE(fut.poll(cx).has_value());
+    EXPECT_EQ(tx.availableBudget(), 0);
+
+    EXPECT_EQ(rx.tryRecv().unwrap().size(), 1000);
+    EXPECT_EQ(tx.availableBudget(), 100);
+}
+
+TEST(Weighted, ClosedByReceiver) {
+    Waker waker = Waker::noop();
+    Context cx { &waker };
+
+    auto [tx, rx] = weighted::channel<std::vector<uint8_t>>(10, bufferWeight);
+    EXPECT_TRUE(tx.trySend(std::vector<uint8_t>(10)).isOk());
+
+    auto fut = tx.send(std::vector<uint8_t>(5));
+    EXPECT_FALSE(fut.poll(cx).has_value());
+
+    arc::drop(std::move(rx));
+
+    auto p = fut.poll(cx);
+    EXPECT_TRUE(p.has_value());
+    EXPECT_TRUE(p->isErr());
+    EXPECT_EQ(p->unwrapErr().size(), 5);
+
+    EXPECT_TRUE(tx.trySend(std::vector<uint8_t>(1)).isErr());
+}
+
+TEST(Weighted, LargeVolume) {
+    auto rt = arc::Runtime::create(4);
+    auto [tx, rx] = weighted::channel<std::vector<uint8_t>>(4096, bufferWeight);
+
+    auto [a, b] = rt->blockOn([&] -> arc::Future<std::pair<uint64_t, uint64_t>> {
+        auto handle = arc::spawn([rx = std::move(rx)] mutable -> arc::Future<uint64_t> {
+            uint64_t total = 0;
+
+            while (true) {
+                auto res = co_await rx.recv();
+                if (!res) break;
+                total += res.unwrap().size();
+            }
+
+            co_return total;
+        });
+
+        uint64_t actual = 0;
+        for (size_t i = 0; i < 1024; i++) {
+            size_t size = (i * 37) % 2048 + 1;
+            EXPECT_TRUE((co_await tx.send(std::vector<uint8_t>(size))).isOk());
+            actual += size;
+        }
+
+        arc::drop(std::move(tx));
+
+        co_return std::make_pair(actual, co_await handle);
+    });
+
+    EXPECT_EQ(a, b);
+}